@@ -0,0 +1,177 @@
+#include "Batch.hpp"
+#include "Input.hpp"
+#include "Commands.hpp"
+#include "ErrorsLogging.hpp"
+#include "MappedFile.hpp"
+#include "Output.hpp"
+#include "ThreadPool.hpp"
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+// lines per task : large enough to make the scheduling cost negligible
+constexpr std::size_t chunkSize{ 1024 };
+
+// tasks submitted but whose results aren't written yet, per thread, to bound the memory used by pending results
+constexpr std::size_t pendingChunksPerThread{ 4 };
+
+struct ChunkOutput {
+	std::string results{};
+	std::string errors{};
+};
+
+// calls 'processLine' with each line of 'content', without its line break, and its number, until the end or a 'quit' line
+template<typename LineProcessor>
+static void forEachLine(std::string_view content, LineProcessor processLine) {
+	for (std::size_t lineBegin{}, lineNumber{ 1 }; lineBegin < content.size(); lineNumber++) {
+		auto lineEnd{ content.find('\n', lineBegin) };
+		if (lineEnd == std::string_view::npos) {
+			lineEnd = content.size();
+		}
+
+		auto line{ content.substr(lineBegin, lineEnd - lineBegin) };
+		if (line.ends_with('\r')) {
+			line.remove_suffix(1);
+		}
+		lineBegin = lineEnd + 1;
+
+		if (line == "quit") {
+			return;
+		}
+		processLine(line, lineNumber);
+	}
+}
+
+// as processInput, but 'help' is written at once into output(), as the other results : a batch has no console to turn its pages
+static void processBatchLine(const std::string& input) {
+	if (input == "help") {
+		help(false);
+	}
+	else {
+		processInput(input);
+	}
+}
+
+// lines which must not run at the same time as any other, because they may modify variables or read user input
+static bool isBarrier(std::string_view line) {
+	return line == "help" || isCommand(line);
+}
+
+// lines of a chunk follow each other in the file
+static ChunkOutput processChunk(const std::vector<std::string_view>& lines, std::size_t firstLineNumber) {
+	// reused by the chunks processed by the same thread, so that they are only copied once into their ChunkOutput
+	thread_local StringWriter results{};
+	thread_local StringWriter errors{};
+	results.clear();
+	errors.clear();
+	std::ostream resultsStream{ &results };
+	std::ostream errorsStream{ &errors };
+	const OutputRedirection outputRedirection{ resultsStream };
+	const ErrorOutputRedirection errorOutputRedirection{ errorsStream };
+
+	thread_local std::string input{};
+	for (std::size_t i{}; i < lines.size(); i++) {
+		input.assign(lines[i]);
+		setDiagnosticsLine(firstLineNumber + i);
+		processInput(input);
+	}
+	return { std::string{ results.view() }, std::string{ errors.view() } };
+}
+
+static void runSequentially(std::string_view content) {
+	std::string input{}; // reused for each line, so that it only allocates for the longest ones
+
+	forEachLine(content, [&input](std::string_view line, std::size_t lineNumber) {
+		input.assign(line);
+		setDiagnosticsLine(lineNumber);
+		processBatchLine(input);
+	});
+}
+
+static void runInParallel(std::string_view content, std::size_t threadCount) {
+	ThreadPool pool{ threadCount };
+	std::deque<std::future<ChunkOutput>> pendingChunks{};
+	std::vector<std::string_view> chunkLines{};
+	std::size_t chunkFirstLineNumber{};
+	std::string input{};
+
+	const auto writeOldestChunk = [&pendingChunks] {
+		const auto chunk{ pendingChunks.front().get() };
+		pendingChunks.pop_front();
+		output() << chunk.results;
+		errorOutput() << chunk.errors;
+	};
+
+	const auto submitChunk = [&] {
+		if (chunkLines.empty()) {
+			return;
+		}
+
+		// std::function must be copyable, std::packaged_task isn't
+		auto task{ std::make_shared<std::packaged_task<ChunkOutput()>>([lines = std::move(chunkLines), chunkFirstLineNumber] { return processChunk(lines, chunkFirstLineNumber); }) };
+		chunkLines.clear();
+		pendingChunks.push_back(task->get_future());
+		pool.submit([task] { (*task)(); });
+
+		if (pendingChunks.size() >= pendingChunksPerThread * pool.size()) {
+			writeOldestChunk();
+		}
+	};
+
+	forEachLine(content, [&](std::string_view line, std::size_t lineNumber) {
+		if (!isBarrier(line)) {
+			if (chunkLines.empty()) {
+				chunkFirstLineNumber = lineNumber;
+			}
+			chunkLines.push_back(line);
+			if (chunkLines.size() == chunkSize) {
+				submitChunk();
+			}
+			return;
+		}
+
+		submitChunk();
+		while (!pendingChunks.empty()) {
+			writeOldestChunk();
+		}
+		input.assign(line);
+		setDiagnosticsLine(lineNumber);
+		processBatchLine(input);
+	});
+
+	submitChunk();
+	while (!pendingChunks.empty()) {
+		writeOldestChunk();
+	}
+}
+
+int runBatch(const std::string& path, std::size_t threadCount) {
+	const MappedFile file{ path };
+	if (!file.isOpen()) {
+		std::cerr << "Unexpected error while trying to read batch file '" << path << "' !" << std::endl;
+		return 1;
+	}
+
+	BufferedWriter writer{ stdout };
+	std::ostream batchOutput{ &writer };
+	const OutputRedirection redirection{ batchOutput };
+
+	// errors are buffered as well, so that files with many bad lines aren't slowed down by writing them
+	BufferedWriter errorWriter{ stderr };
+	std::ostream batchErrorOutput{ &errorWriter };
+	const ErrorOutputRedirection errorRedirection{ batchErrorOutput };
+
+	if (threadCount > 1) {
+		runInParallel(file.content(), threadCount);
+	}
+	else {
+		runSequentially(file.content());
+	}
+
+	batchOutput.flush();
+	batchErrorOutput.flush();
+	return 0;
+}
\ No newline at end of file
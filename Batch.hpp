@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+// processes each line of the file as if it were typed in the console, until its end or a 'quit' line
+// the file is mapped in memory, results and errors are written into stdout and stderr through large buffers
+// with --diagnostics=json, diagnostics refer to the lines by their number in the file, text diagnostics don't tell it
+// with several threads, formulas are evaluated in parallel but results are still written in the input order,
+// and commands (as well as 'help') are barriers : they run alone, once all the previous lines are done
+// returns the exit code of the program
+int runBatch(const std::string& path, std::size_t threadCount = 1);
\ No newline at end of file
@@ -0,0 +1,78 @@
+// counts the heap allocations made while evaluating formulas once the evaluation arena and the cache are warm
+// build : the 'allocation_benchmark' CMake target, which returns 1 if any line allocates once warm
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "ExpressionCache.hpp"
+#include "Input.hpp"
+#include "Output.hpp"
+
+static std::size_t allocations{};
+
+void* operator new(std::size_t size) {
+	allocations++;
+	if (void* pointer{ std::malloc(size == 0 ? 1 : size) }) {
+		return pointer;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+int main() {
+	constexpr std::array<std::string_view, 6> formulas{
+		"1+2",
+		"2pi(3 + 4) - [5 * 6] / 7",
+		"   ((((1 + 2) * 3) - 4) / 5) ^ 2 % 3   ",
+		"radius^2 * pi + 2 * radius * height_of_the_cylinder * pi",
+		"-radius * -2 + [height_of_the_cylinder - 1](radius + 1)e",
+		"1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11 + 12 + 13 + 14 + 15 + 16 + 17 + 18 + 19 + 20"
+	};
+	constexpr std::size_t runs{ 10'000 };
+
+	std::ostream discardedOutput{ nullptr };
+	const OutputRedirection redirection{ discardedOutput };
+
+	std::string input{};
+	const auto processAll = [&input, &formulas] {
+		for (const auto formula : formulas) {
+			input.assign(formula);
+			processInput(input);
+		}
+	};
+
+	input = "set radius 2.5";
+	processInput(input);
+	input = "set height_of_the_cylinder 10";
+	processInput(input);
+	// warms up the cache and the arena, until the formulas are hot enough to be compiled into threaded code, which allocates once
+	// the first run compiles and caches them, the next ones evaluate the cached expressions
+	for (std::size_t i{}; i <= CachedExpression::hotEvaluations; i++) {
+		processAll();
+	}
+
+	const auto allocationsBefore{ allocations };
+	for (std::size_t i{}; i < runs; i++) {
+		processAll();
+	}
+	const auto evaluatedLines{ runs * formulas.size() };
+
+	std::cout << "lines\tallocations\tallocations per line" << std::endl;
+	std::cout << evaluatedLines << '\t' << allocations - allocationsBefore << "\t\t" << static_cast<double>(allocations - allocationsBefore) / static_cast<double>(evaluatedLines) << std::endl;
+
+	if (allocations != allocationsBefore) {
+		std::cerr << "Warm lines allocated " << allocations - allocationsBefore << " times !" << std::endl;
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
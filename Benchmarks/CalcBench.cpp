@@ -0,0 +1,307 @@
+// microbenchmarks of each stage of the evaluation pipeline, results are written as JSON on the standard output
+// build : the 'calc_bench' CMake target
+// usage : calc_bench [--filter <substring>] [--min-time <seconds>]
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Commands.hpp"
+#include "EvaluationArena.hpp"
+#include "Expression.hpp"
+#include "ExpressionCache.hpp"
+#include "Input.hpp"
+#include "Optimizer.hpp"
+#include "Output.hpp"
+#include "Result.hpp"
+#include "SyntaxChecking.hpp"
+
+struct BenchmarkResult {
+	std::string name{};
+	std::size_t iterations{};
+	double nanosecondsPerIteration{};
+};
+
+struct BenchmarkOptions {
+	std::string filter{};
+	double minTime{ 0.2 }; // in seconds
+};
+
+// prevents the compiler from removing the computation of value
+template<typename T>
+static void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&value) : "memory");
+#else
+	static volatile const void* sink{};
+	sink = &value;
+#endif
+}
+
+// runs function with more and more iterations, until it lasts at least options.minTime
+static std::optional<BenchmarkResult> run(const BenchmarkOptions& options, std::string name, const std::function<void()>& function) {
+	if (name.find(options.filter) == std::string::npos) {
+		return std::nullopt;
+	}
+
+	function(); // warms up the caches and the arena
+	for (std::size_t iterations{ 1 };; iterations *= 2) {
+		const auto begin{ std::chrono::steady_clock::now() };
+		for (std::size_t i{}; i < iterations; i++) {
+			function();
+		}
+		const std::chrono::duration<double> duration{ std::chrono::steady_clock::now() - begin };
+
+		if (duration.count() >= options.minTime) {
+			return BenchmarkResult{ std::move(name), iterations, duration.count() * 1e9 / static_cast<double>(iterations) };
+		}
+	}
+}
+
+static void writeJson(const std::vector<BenchmarkResult>& results) {
+	std::cout << "{\n\t\"benchmarks\": [\n";
+	for (std::size_t i{}; i < results.size(); i++) {
+		std::cout << "\t\t{ \"name\": \"" << results[i].name << "\", \"iterations\": " << results[i].iterations
+			<< ", \"ns_per_iteration\": " << results[i].nanosecondsPerIteration << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+	}
+	std::cout << "\t]\n}" << std::endl;
+}
+
+// "(1+2*3)-[4+5*6]*(7+8*9)/..." with 'terms' numbers, grouped 3 by 3 in parenthesises or square brackets
+// groups are positive, so that there is no division by zero
+static std::string longFormula(std::size_t terms) {
+	constexpr std::string_view groupsOperators{ "-*/+" };
+	std::string formula{};
+
+	for (std::size_t i{}; i < terms; i++) {
+		if (i % 3 == 0) {
+			formula += (i / 3) % 2 == 0 ? '(' : '[';
+		}
+		formula += std::to_string(i % 9 + 1);
+		if (i % 3 == 2 || i == terms - 1) {
+			formula += (i / 3) % 2 == 0 ? ')' : ']';
+		}
+		if (i != terms - 1) {
+			formula += i % 3 == 2 ? groupsOperators[(i / 3) % groupsOperators.size()] : "+*"[i % 3];
+		}
+	}
+	return formula;
+}
+
+// "(1 + (2 + (3 + ... ) * 2) * 2) * 2" with 'depth' nested parenthesises
+static std::string nestedFormula(std::size_t depth) {
+	std::string formula{};
+	for (std::size_t i{}; i < depth; i++) {
+		formula += '(' + std::to_string(i % 9 + 1) + " + ";
+	}
+	formula += '1';
+	for (std::size_t i{}; i < depth; i++) {
+		formula += ") * 2";
+	}
+	return formula;
+}
+
+// "(radius*1+radius/2-...)^2 + 3[radius*1+radius/2-...] + ..." : 'copies' copies of a subterm of 'terms' operands, in parenthesises
+// or square brackets, as produced by formula generators, the subterm is only computed once as the copies are shared
+static std::string repeatedSubtermsFormula(std::size_t copies, std::size_t terms) {
+	constexpr std::string_view termsOperators{ "*+/-" };
+	std::string subterm{};
+	for (std::size_t i{}; i < terms; i++) {
+		subterm += "radius";
+		subterm += termsOperators[(2 * i) % termsOperators.size()];
+		subterm += std::to_string(i % 9 + 1);
+		if (i != terms - 1) {
+			subterm += termsOperators[(2 * i + 1) % termsOperators.size()];
+		}
+	}
+
+	std::string formula{};
+	for (std::size_t i{}; i < copies; i++) {
+		formula += i == 0 ? "" : " + ";
+		formula += std::to_string(i + 1);
+		formula += i % 2 == 0 ? '(' : '[';
+		formula += subterm;
+		formula += i % 2 == 0 ? ')' : ']';
+	}
+	return formula;
+}
+
+static void benchmarkFrontEnd(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results, std::string_view label, const std::string& formula) {
+	const auto add = [&results](std::optional<BenchmarkResult> result) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	};
+	const std::string prefix{ std::string{ label } + '/' };
+
+	std::pmr::string withoutSpaces{};
+	std::pmr::string withMultiplications{};
+	std::pmr::string simplified{};
+	std::pmr::vector<Token> tokens{};
+	removeSpaces(formula, withoutSpaces);
+	addImplicitMultiplyOperators(withoutSpaces, withMultiplications);
+	simplifyOperators(withMultiplications, simplified);
+	tokenize(simplified, tokens);
+	const auto expression{ parse(tokens) };
+	const auto optimizedExpression{ optimize(expression) };
+	evaluationArena.reset();
+
+	add(run(options, prefix + "removeSpaces", [&] { removeSpaces(formula, withoutSpaces); keep(withoutSpaces); }));
+	add(run(options, prefix + "addImplicitMultiplyOperators", [&] { addImplicitMultiplyOperators(withoutSpaces, withMultiplications); keep(withMultiplications); }));
+	add(run(options, prefix + "simplifyOperators", [&] { simplifyOperators(withMultiplications, simplified); keep(simplified); }));
+	add(run(options, prefix + "tokenize", [&] { tokenize(simplified, tokens); keep(tokens); }));
+	add(run(options, prefix + "parse", [&] { keep(parse(tokens)); evaluationArena.reset(); }));
+	add(run(options, prefix + "optimize", [&] { keep(optimize(expression)); evaluationArena.reset(); }));
+	add(run(options, prefix + "evaluate", [&] { keep(evaluate(expression)); evaluationArena.reset(); }));
+	add(run(options, prefix + "evaluate/optimized", [&] { keep(evaluate(optimizedExpression)); evaluationArena.reset(); }));
+	add(run(options, prefix + "isSyntaxCorrect", [&] { keep(isSyntaxCorrect(formula)); }));
+	add(run(options, prefix + "result/cached", [&] { keep(result(formula)); evaluationArena.reset(); }));
+
+	const auto capacity{ ExpressionCache::capacity() };
+	ExpressionCache::setCapacity(0);
+	add(run(options, prefix + "result/uncached", [&] { keep(result(formula)); evaluationArena.reset(); }));
+	ExpressionCache::setCapacity(capacity);
+}
+
+static void benchmarkSyntaxErrors(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+	const std::string invalidFormula{ "3 $ (4 + ] * 2.5.1 + unknown_variable ++ ()" + longFormula(100) };
+	const std::string validFormula{ longFormula(100) };
+
+	for (auto result : {
+		run(options, "syntax/valid/isSyntaxCorrect", [&] { keep(isSyntaxCorrect(validFormula)); }),
+		run(options, "syntax/invalid/isSyntaxCorrect", [&] { keep(isSyntaxCorrect(invalidFormula)); }),
+		run(options, "syntax/invalid/diagnose", [&] { keep(syntax::diagnose(invalidFormula)); })
+		}) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	}
+}
+
+// command lines, which are parsed once and dispatched through a perfect hash, as in scripts made of thousands of 'set'
+static void benchmarkCommands(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+	std::ostream discardedOutput{ nullptr };
+	const OutputRedirection redirection{ discardedOutput };
+	const ErrorOutputRedirection errorRedirection{ discardedOutput };
+
+	const std::string setValue{ "set width 12.5" };
+	const std::string setFormula{ "set area width * (width + 1) / 2" };
+	const std::string badName{ "set 2width 12.5" };
+	for (auto result : {
+		run(options, "commands/set/value", [&] { processInput(setValue); }),
+		run(options, "commands/set/formula", [&] { processInput(setFormula); }),
+		run(options, "commands/set/bad_name", [&] { processInput(badName); })
+		}) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	}
+
+	processInput("reset");
+}
+
+// numbers written as results are displayed, and as in text save files, into a buffer which is reused as in batch runs
+static void benchmarkNumberOutput(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+	StringWriter writer{};
+	std::ostream stream{ &writer };
+	char text[number::maxCharsSize];
+	Number value{ Number{ 1 } / 7 };
+
+	for (auto result : {
+		run(options, "output/number/display", [&] { writer.clear(); writeNumber(stream, value); keep(writer); value += 1; }),
+		run(options, "output/number/shortest", [&] { keep(number::toChars(text, text + sizeof(text), value)); value += 1; })
+		}) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	}
+}
+
+// saves and loads 'count' variables through the 'save', 'savetext' and 'load' commands, in a temporary directory
+static void benchmarkSaveFiles(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results, std::size_t count) {
+	const auto previousDirectory{ std::filesystem::current_path() };
+	const auto directory{ std::filesystem::temp_directory_path() / "calc_bench" };
+	std::filesystem::create_directories(directory);
+	std::filesystem::current_path(directory);
+
+	std::ostream discardedOutput{ nullptr };
+	const OutputRedirection redirection{ discardedOutput };
+	const ErrorOutputRedirection errorRedirection{ discardedOutput };
+
+	// names made of letters only, as variable names can't contain digits
+	for (std::size_t i{}; i < count; i++) {
+		std::string name{ "var_" };
+		for (auto n{ i }; n != 0 || name.size() == 4; n /= 26) {
+			name += static_cast<char>('a' + n % 26);
+		}
+		processInput("set " + name + ' ' + std::to_string(i) + ".5");
+	}
+
+	const auto label{ std::to_string(count) + "_variables/" };
+	for (auto result : {
+		run(options, "save/binary/" + label + "save", [] { processInput("save"); }),
+		run(options, "save/binary/" + label + "load", [] { processInput("load"); }),
+		run(options, "save/text/" + label + "save", [] { processInput("savetext"); }),
+		run(options, "save/text/" + label + "load", [] { processInput("load"); }),
+		run(options, "save/binary/" + label + "set_and_save", [] { processInput("set var_a 1.5"); processInput("save"); })
+		}) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	}
+
+	// saving a modified variable with the journal, which appends a record rather than writing all of them as 'set_and_save',
+	// and is compacted in the background once it is as large as the snapshot
+	processInput("journal on");
+	for (auto result : {
+		run(options, "save/journal/" + label + "set", [] { processInput("set var_a 1.5"); }),
+		run(options, "save/journal/" + label + "load", [] { processInput("load"); })
+		}) {
+		if (result.has_value()) {
+			results.push_back(std::move(result.value()));
+		}
+	}
+	processInput("journal off");
+
+	processInput("reset");
+	std::filesystem::current_path(previousDirectory);
+	std::filesystem::remove_all(directory);
+}
+
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options{};
+	for (int i{ 1 }; i + 1 < argc; i += 2) {
+		const std::string_view option{ argv[i] };
+		if (option == "--filter") {
+			options.filter = argv[i + 1];
+		}
+		else if (option == "--min-time") {
+			options.minTime = std::stod(argv[i + 1]);
+		}
+		else {
+			std::cerr << "Usage : " << argv[0] << " [--filter <substring>] [--min-time <seconds>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<BenchmarkResult> results{};
+	processInput("set radius 2.5");
+	benchmarkFrontEnd(options, results, "short", "2pi(radius + 4) - [5 * 6] / 7");
+	benchmarkFrontEnd(options, results, "long", longFormula(1'000));
+	benchmarkFrontEnd(options, results, "nested", nestedFormula(500));
+	benchmarkFrontEnd(options, results, "repeated", repeatedSubtermsFormula(8, 50));
+	processInput("def ring(r, width) = pi*((r + width)^2 - r^2)");
+	benchmarkFrontEnd(options, results, "call", "ring(radius, 0.5) + ring(2radius, 1)");
+	benchmarkFrontEnd(options, results, "inline", "pi*((radius + 0.5)^2 - radius^2) + pi*((2radius + 1)^2 - (2radius)^2)");
+	benchmarkSyntaxErrors(options, results);
+	benchmarkCommands(options, results);
+	benchmarkNumberOutput(options, results);
+	benchmarkSaveFiles(options, results, 100'000);
+
+	writeJson(results);
+	return 0;
+}
\ No newline at end of file
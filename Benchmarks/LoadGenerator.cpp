@@ -0,0 +1,178 @@
+// load generator for 'calculator --serve <socket>' : each connection sends a request, waits for its response, and so on
+// writes the requests per second and the latency percentiles as JSON on the standard output
+// build : the 'load_generator' CMake target (Linux only)
+// usage : load_generator <socket> [--connections <N>] [--requests <N per connection>] [--formula <formula>]
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct LoadOptions {
+	std::string socketPath{};
+	std::size_t connections{ 4 };
+	std::size_t requests{ 10'000 }; // per connection
+	std::string formula{ "3x^2 - 2x / (x + 1) + [x - 0.5] * pi" }; // x is set by each connection, to a different value
+};
+
+using Latency = std::chrono::duration<double, std::micro>;
+
+class Client {
+public:
+	explicit Client(const std::string& socketPath) :
+		fileDescriptor{ socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) }
+	{
+		sockaddr_un address{ .sun_family = AF_UNIX, .sun_path = {} };
+		socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+		connected = fileDescriptor != -1 && connect(fileDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+	}
+
+	~Client() {
+		if (fileDescriptor != -1) {
+			close(fileDescriptor);
+		}
+	}
+
+	Client(const Client&) = delete;
+	Client& operator=(const Client&) = delete;
+
+	bool isConnected() const noexcept {
+		return connected;
+	}
+
+	// sends request and waits for its whole response, false if the connection failed
+	bool request(std::string_view request) {
+		pending.assign(request);
+		pending += '\n';
+		for (std::size_t sent{}; sent < pending.size();) {
+			const auto count{ send(fileDescriptor, pending.data() + sent, pending.size() - sent, MSG_NOSIGNAL) };
+			if (count <= 0) {
+				return false;
+			}
+			sent += static_cast<std::size_t>(count);
+		}
+
+		// a response ends with an empty line, the other ones start with '=' or '!'
+		while (true) {
+			for (std::size_t lineBegin{}; lineBegin < received.size();) {
+				const auto lineEnd{ received.find('\n', lineBegin) };
+				if (lineEnd == std::string::npos) {
+					break;
+				}
+				if (lineEnd == lineBegin) {
+					received.erase(0, lineEnd + 1);
+					return true;
+				}
+				lineBegin = lineEnd + 1;
+			}
+
+			char buffer[4096];
+			const auto count{ read(fileDescriptor, buffer, sizeof(buffer)) };
+			if (count <= 0) {
+				return false;
+			}
+			received.append(buffer, static_cast<std::size_t>(count));
+		}
+	}
+
+private:
+	int fileDescriptor{ -1 };
+	bool connected{};
+	std::string pending{};
+	std::string received{};
+};
+
+// latencies of the requests of one connection, nullopt if it failed
+static std::optional<std::vector<Latency>> runConnection(const LoadOptions& options, std::size_t index) {
+	Client client{ options.socketPath };
+	if (!client.isConnected() || !client.request("set x " + std::to_string(index + 1))) {
+		return std::nullopt;
+	}
+
+	std::vector<Latency> latencies{};
+	latencies.reserve(options.requests);
+	for (std::size_t i{}; i < options.requests; i++) {
+		const auto begin{ std::chrono::steady_clock::now() };
+		if (!client.request(options.formula)) {
+			return std::nullopt;
+		}
+		latencies.push_back(std::chrono::steady_clock::now() - begin);
+	}
+	return latencies;
+}
+
+// assumes sortedLatencies isn't empty
+static double percentile(const std::vector<Latency>& sortedLatencies, double fraction) {
+	const auto index{ static_cast<std::size_t>(fraction * static_cast<double>(sortedLatencies.size() - 1)) };
+	return sortedLatencies[index].count();
+}
+
+int main(int argc, char* argv[]) {
+	const auto usage = [argv] {
+		std::cerr << "Usage : " << argv[0] << " <socket> [--connections <N>] [--requests <N per connection>] [--formula <formula>]" << std::endl;
+		return 1;
+	};
+	if (argc < 2) {
+		return usage();
+	}
+
+	LoadOptions options{ .socketPath = argv[1] };
+	for (int i{ 2 }; i < argc; i += 2) {
+		const std::string_view option{ argv[i] };
+		if (i + 1 == argc) {
+			return usage();
+		}
+		else if (option == "--connections") {
+			options.connections = std::stoul(argv[i + 1]);
+		}
+		else if (option == "--requests") {
+			options.requests = std::stoul(argv[i + 1]);
+		}
+		else if (option == "--formula") {
+			options.formula = argv[i + 1];
+		}
+		else {
+			return usage();
+		}
+	}
+	if (options.connections == 0 || options.requests == 0) {
+		return usage();
+	}
+
+	std::vector<std::optional<std::vector<Latency>>> connectionsLatencies(options.connections);
+	const auto begin{ std::chrono::steady_clock::now() };
+	{
+		std::vector<std::jthread> threads{};
+		for (std::size_t i{}; i < options.connections; i++) {
+			threads.emplace_back([&options, &connectionsLatencies, i] { connectionsLatencies[i] = runConnection(options, i); });
+		}
+	}
+	const std::chrono::duration<double> duration{ std::chrono::steady_clock::now() - begin };
+
+	std::vector<Latency> latencies{};
+	for (const auto& connectionLatencies : connectionsLatencies) {
+		if (!connectionLatencies.has_value()) {
+			std::cerr << "Unexpected error while trying to send requests to '" << options.socketPath << "' !" << std::endl;
+			return 1;
+		}
+		latencies.insert(latencies.end(), connectionLatencies->begin(), connectionLatencies->end());
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	std::cout << "{\n"
+		<< "\t\"connections\": " << options.connections << ",\n"
+		<< "\t\"requests\": " << latencies.size() << ",\n"
+		<< "\t\"requests_per_second\": " << static_cast<double>(latencies.size()) / duration.count() << ",\n"
+		<< "\t\"p50_us\": " << percentile(latencies, 0.5) << ",\n"
+		<< "\t\"p99_us\": " << percentile(latencies, 0.99) << ",\n"
+		<< "\t\"max_us\": " << latencies.back().count() << '\n'
+		<< "}" << std::endl;
+	return 0;
+}
\ No newline at end of file
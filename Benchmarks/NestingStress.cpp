@@ -0,0 +1,98 @@
+// evaluates formulas nested up to a million times, which are parsed and evaluated without recursion, then checks that the
+// formulas nested deeper than the limit are rejected with Error::NestingTooDeep
+// build : the 'nesting_stress' CMake target, which returns 1 if a result is wrong
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "EvaluationArena.hpp"
+#include "ExpressionCache.hpp"
+#include "PipelineStatistics.hpp"
+#include "Result.hpp"
+#include "SyntaxChecking.hpp"
+
+struct NestedFormula {
+	std::string_view name{};
+	std::function<std::string(std::size_t)> formula{};	// nested 'depth' times
+	std::function<Number(std::size_t)> value{};			// of the formula nested 'depth' times
+};
+
+// each level opens with 'open(level)' and closes with the matching delimiter, around 'innermost'
+static std::string nested(std::size_t depth, const std::function<std::string_view(std::size_t)>& open, std::string_view innermost) {
+	std::string formula{};
+	for (std::size_t level{}; level < depth; level++) {
+		formula += open(level);
+	}
+	formula += innermost;
+	for (auto level{ depth }; level-- > 0;) {
+		formula += open(level).find('[') == std::string_view::npos ? ')' : ']';
+	}
+	return formula;
+}
+
+static bool evaluateNestedFormulas() {
+	const NestedFormula formulas[]{
+		{ "parenthesises", [](std::size_t depth) { return nested(depth, [](std::size_t) { return "("; }, "1"); }, [](std::size_t) { return Number{ 1 }; } },
+		{ "sums", [](std::size_t depth) { return nested(depth, [](std::size_t) { return "(1+"; }, "1"); }, [](std::size_t depth) { return static_cast<Number>(depth + 1); } },
+		{ "mixed_delimiters", [](std::size_t depth) { return nested(depth, [](std::size_t level) { return level % 2 == 0 ? "(1-" : "[1-"; }, "1"); },
+			[](std::size_t depth) { return depth % 2 == 0 ? Number{ 1 } : Number{ 0 }; } },
+		{ "implicit_products", [](std::size_t depth) { return nested(depth, [](std::size_t) { return "2("; }, "1"); },
+			[](std::size_t depth) { return number::pow(Number{ 2 }, static_cast<Number>(depth)); } }
+	};
+
+	bool success{ true };
+	std::cout << "formula\t\t\tdepth\ttime (ms)\tns per level\tarena bytes per level" << std::endl;
+	for (const auto& nestedFormula : formulas) {
+		for (std::size_t depth{ 10 }; depth <= 1'000'000; depth *= 10) {
+			const auto formula{ nestedFormula.formula(depth) };
+			const auto allocatedBytes{ evaluationArena.allocatedBytes() };
+
+			const auto begin{ std::chrono::steady_clock::now() };
+			const bool isCorrect{ isSyntaxCorrect(formula) };
+			const auto value{ isCorrect ? result(formula) : EvaluationResult{ Error::MissingFormula } };
+			const std::chrono::duration<double, std::milli> duration{ std::chrono::steady_clock::now() - begin };
+
+			const auto levelBytes{ static_cast<double>(evaluationArena.allocatedBytes() - allocatedBytes) / static_cast<double>(depth) };
+			evaluationArena.reset();
+
+			std::cout << nestedFormula.name << "\t\t" << depth << '\t' << duration.count() << "\t\t" << duration.count() * 1e6 / static_cast<double>(depth)
+				<< "\t\t" << (arePipelineStatisticsEnabled ? std::to_string(levelBytes) : "-") << std::endl;
+
+			if (const auto exactValue{ std::get_if<Value>(&value) }; exactValue == nullptr || toNumber(*exactValue) != nestedFormula.value(depth)) {
+				std::cerr << "Wrong result for '" << nestedFormula.name << "' nested " << depth << " times !" << std::endl;
+				success = false;
+			}
+		}
+	}
+	return success;
+}
+
+// the first delimiter beyond the limit is reported, the formula nested exactly 'limit' times is accepted
+static bool checkNestingLimit(std::size_t limit) {
+	setMaxNestingDepth(limit);
+	const auto deepest{ nested(limit, [](std::size_t) { return "("; }, "1") };
+	const auto tooDeep{ nested(limit + 1, [](std::size_t) { return "("; }, "1") };
+	const bool isDeepestAccepted{ isSyntaxCorrect(deepest) };
+	const auto diagnostics{ syntax::diagnose(tooDeep) };
+	const auto& errorIndexes{ diagnostics[static_cast<std::size_t>(Error::NestingTooDeep)] };
+	setMaxNestingDepth(defaultMaxNestingDepth);
+
+	if (!isDeepestAccepted || errorIndexes.size() != 1 || errorIndexes[0] != limit) {
+		std::cerr << "The nesting limit of " << limit << " isn't enforced !" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	ExpressionCache::setCapacity(0); // formulas of megabytes aren't worth keeping
+
+	bool success{ evaluateNestedFormulas() };
+	for (const std::size_t limit : { std::size_t{ 1 }, std::size_t{ 100 }, defaultMaxNestingDepth }) {
+		success = checkNestingLimit(limit) && success;
+	}
+	return success ? 0 : 1;
+}
\ No newline at end of file
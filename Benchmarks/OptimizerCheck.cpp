@@ -0,0 +1,79 @@
+// checks that optimizing a formula keeps its value, down to the sign of zero, and its error, on the cases the rewrites could break
+// build : the 'optimizer_check' CMake target, which returns 1 if an optimized formula differs
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "EvaluationArena.hpp"
+#include "Expression.hpp"
+#include "Lexer.hpp"
+#include "Optimizer.hpp"
+#include "Result.hpp"
+
+// the expression as parsed, before optimize()
+static Expression parseFormula(std::string_view formula) {
+	std::pmr::string withoutSpaces{};
+	std::pmr::string withMultiplications{};
+	std::pmr::string simplified{};
+	std::pmr::vector<Token> tokens{};
+	removeSpaces(formula, withoutSpaces);
+	addImplicitMultiplyOperators(withoutSpaces, withMultiplications);
+	simplifyOperators(withMultiplications, simplified);
+	tokenize(simplified, tokens);
+	return parse(tokens);
+}
+
+// same error, or same number with the same sign, NaN being the same as NaN
+static bool isSameResult(const EvaluationResult& first, const EvaluationResult& second) {
+	const auto firstValue{ std::get_if<Value>(&first) };
+	const auto secondValue{ std::get_if<Value>(&second) };
+	if (firstValue == nullptr || secondValue == nullptr) {
+		return firstValue == secondValue && std::get<Error>(first) == std::get<Error>(second);
+	}
+	const auto firstNumber{ toNumber(*firstValue) };
+	const auto secondNumber{ toNumber(*secondValue) };
+	if (firstNumber != firstNumber || secondNumber != secondNumber) { // NaN
+		return firstNumber != firstNumber && secondNumber != secondNumber;
+	}
+	return firstNumber == secondNumber && number::signbit(firstNumber) == number::signbit(secondNumber);
+}
+
+int main() {
+	variables.set("z", integerValue(0));
+	variables.set("x", toValue(Number{ 2.5 }));
+
+	constexpr std::string_view formulas[]{
+		"-0.5z + 0",		// -0 + 0 is 0, so x + 0 isn't x
+		"0 + -0.5z",
+		"-0.5z - 0",
+		"-0.5z + -(0.5z)",
+		"(1/0)^0",			// x^0 is 1 only if x doesn't fail
+		"(2 % 0)^0",
+		"(x/z)^0",
+		"(-(x % z))^0",
+		"(1/0)^1",
+		"(x - x)^0",
+		"x^0",
+		"(x/2)^0",			// may fail, but doesn't : kept and evaluated
+		"(x*1)/z",
+		"x^3 + x^8"
+	};
+
+	bool success{ true };
+	for (const auto formula : formulas) {
+		const auto expression{ parseFormula(formula) };
+		const auto optimizedExpression{ optimize(expression) };
+		const auto value{ evaluate(expression) };
+		const auto optimizedValue{ evaluate(optimizedExpression) };
+		evaluationArena.reset();
+
+		if (!isSameResult(value, optimizedValue)) {
+			std::cerr << "Optimizing '" << formula << "' changes its result !" << std::endl;
+			success = false;
+		}
+	}
+	return success ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+// compares the shunting-yard parser with the previous one, which repeatedly looked for the most nested area and the
+// highest priority operator, on long formulas
+// build : the 'parser_benchmark' CMake target
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Expression.hpp"
+#include "Result.hpp"
+#include "EvaluationArena.hpp"
+
+namespace legacy {
+	// while parsing, the formula is a mix of operators / delimiters not yet consumed and already built nodes
+	struct ParsingElement {
+		bool isNode{};
+		Token token{};			// only if !isNode
+		std::size_t node{};		// only if isNode
+	};
+
+	// assumes that parenthesises and angle brackets were checked previously
+	// returns { A, B } -> the most nested area is elements[A + 1 to B - 1], A and B being the delimiters
+	std::pair<std::size_t, std::size_t> mostNestedDelimiterIndexes(const std::vector<ParsingElement>& elements) {
+		std::vector<std::size_t> nestingLevels{};
+
+		for (std::size_t i{}; const auto & elem : elements) {
+			if (!elem.isNode && elem.token.type == TokenType::OpeningDelimiter) {
+				if (i++ == 0) {
+					nestingLevels.push_back(1);
+					continue;
+				}
+				nestingLevels.push_back(nestingLevels.back() + 1);
+			}
+			else if (!elem.isNode && elem.token.type == TokenType::ClosingDelimiter) {
+				// cannot be at pos i = 0
+				nestingLevels.push_back(nestingLevels.back() - 1);
+				i++;
+			}
+			else {
+				if (i++ == 0) {
+					nestingLevels.push_back(0);
+					continue;
+				}
+				nestingLevels.push_back(nestingLevels.back());
+			}
+		}
+
+		const auto maxNestingLevel{ *std::max_element(nestingLevels.cbegin(), nestingLevels.cend()) };
+		std::size_t mostNestedOpeningDelimiterIndex{};
+		std::size_t mostNestedClosingDelimiterIndex{};
+		bool hasFoundOpeningDelimiterIndex{};
+
+		// returns the last index with the max value, but the function must return the first
+		for (std::size_t i{}; const auto level : nestingLevels) {
+			if (level == maxNestingLevel) {
+				if (!hasFoundOpeningDelimiterIndex) {
+					hasFoundOpeningDelimiterIndex = true;
+					mostNestedOpeningDelimiterIndex = i;
+				}
+			}
+			if (level < maxNestingLevel && hasFoundOpeningDelimiterIndex) { // we are on the closing delimiter of the max nested area
+				mostNestedClosingDelimiterIndex = i;
+				break;
+			}
+			i++;
+		}
+		return { mostNestedOpeningDelimiterIndex, mostNestedClosingDelimiterIndex };
+	}
+
+	// an operator is a prefix one (unary '-') if nothing is built before it, e.g -> "-3" ; "2*-3"
+	bool isPrefixOperator(const std::vector<ParsingElement>& elements, std::size_t index, std::size_t begin) {
+		return index == begin || !elements[index - 1].isNode;
+	}
+
+	std::size_t maxPriorityOperatorIndex(const std::vector<ParsingElement>& elements, std::size_t begin, std::size_t end) {
+		// priorities are doubled to fit the unary '-' between '/' and '^' => "-2^2" is "-(2^2)" but "-2/4" is "(-2)/4"
+		constexpr std::size_t negatePriority{ 2 * operatorPriority(Operator::Power) - 1 };
+
+		const auto readyOperatorPriority = [&elements, begin](std::size_t i) -> std::size_t {
+			if (elements[i].isNode || !elements[i + 1].isNode) { // not an operator, or its right operand isn't built yet
+				return 0;
+			}
+			return isPrefixOperator(elements, i, begin) ? negatePriority : 2 * operatorPriority(elements[i].token.op);
+		};
+
+		std::size_t maxPriorityIndex{ begin };
+		std::size_t maxPriority{};
+
+		// the first operator with the highest priority is applied first => "2^3^2" is "(2^3)^2"
+		for (std::size_t i{ begin }; i < end - 1; i++) {
+			const auto priority{ readyOperatorPriority(i) };
+			if (priority > maxPriority) {
+				maxPriority = priority;
+				maxPriorityIndex = i;
+			}
+		}
+		return maxPriorityIndex;
+	}
+
+	// assumes tokens come from a formula whose syntax was checked previously
+	Expression parse(std::span<const Token> tokens) {
+		Expression expression{};
+		std::vector<ParsingElement> elements{};
+
+		const auto addNode = [&expression](const Node& node) {
+			expression.nodes.push_back(node);
+			return ParsingElement{ .isNode = true, .node = expression.nodes.size() - 1 };
+		};
+
+		const auto isDelimiterElement = [](const ParsingElement& elem) {
+			return !elem.isNode && (elem.token.type == TokenType::OpeningDelimiter || elem.token.type == TokenType::ClosingDelimiter);
+		};
+
+		for (const auto& token : tokens) {
+			switch (token.type) {
+			case TokenType::Number:
+				elements.push_back(addNode({ .type = NodeType::Number, .number = token.number }));
+				break;
+
+			case TokenType::Variable:
+				elements.push_back(addNode({ .type = NodeType::Variable, .variable = token.variable }));
+				break;
+
+			case TokenType::Operator:
+				// a prefix '+' is useless, e.g -> "2*+3" <=> "2*3"
+				if (token.op == Operator::Plus && (elements.empty() || (!elements.back().isNode && elements.back().token.type != TokenType::ClosingDelimiter))) {
+					break;
+				}
+				elements.push_back({ .token = token });
+				break;
+
+			default:
+				elements.push_back({ .token = token });
+				break;
+			}
+		}
+
+		// builds nodes in elements[begin to end - 1] until there is only one left, assuming no parenthesises and angle brackets remain
+		const auto reduceOperators = [&](std::size_t begin, std::size_t end) {
+			while (end - begin > 1) {
+				const auto operatorIndex{ maxPriorityOperatorIndex(elements, begin, end) };
+				const auto firstElement{ elements.begin() + static_cast<std::ptrdiff_t>(operatorIndex) };
+
+				if (isPrefixOperator(elements, operatorIndex, begin)) {
+					elements[operatorIndex] = addNode({ .type = NodeType::Negate, .left = elements[operatorIndex + 1].node });
+					elements.erase(firstElement + 1);
+					end--;
+				}
+				else {
+					elements[operatorIndex - 1] = addNode({
+						.type = NodeType::Operation,
+						.op = elements[operatorIndex].token.op,
+						.left = elements[operatorIndex - 1].node,
+						.right = elements[operatorIndex + 1].node
+					});
+					elements.erase(firstElement, firstElement + 2);
+					end -= 2;
+				}
+			}
+		};
+
+		// removes the parenthesises and/or angle brackets
+		while (std::find_if(elements.cbegin(), elements.cend(), isDelimiterElement) != elements.cend()) {
+			const auto mostNestedArea{ mostNestedDelimiterIndexes(elements) };
+
+			// mostNestedArea.first + 1, so that it doesn't include the delimiter
+			reduceOperators(mostNestedArea.first + 1, mostNestedArea.second);
+
+			// the area is now "(node)"
+			elements[mostNestedArea.first] = elements[mostNestedArea.first + 1];
+			elements.erase(
+				elements.begin() + static_cast<std::ptrdiff_t>(mostNestedArea.first) + 1,
+				elements.begin() + static_cast<std::ptrdiff_t>(mostNestedArea.first) + 3
+			);
+		}
+
+		reduceOperators(0, elements.size());
+		return expression;
+	}
+}
+
+// "(1+2*3)-[4+5*6]*(7+8*9)/..." with 'terms' numbers, grouped 3 by 3 in parenthesises or square brackets
+// groups are positive, so that there is no division by zero
+static std::string longFormula(std::size_t terms) {
+	constexpr std::string_view groupsOperators{ "-*/+" };
+	std::string formula{};
+
+	for (std::size_t i{}; i < terms; i++) {
+		if (i % 3 == 0) {
+			formula += (i / 3) % 2 == 0 ? '(' : '[';
+		}
+		formula += std::to_string(i % 9 + 1);
+		if (i % 3 == 2 || i == terms - 1) {
+			formula += (i / 3) % 2 == 0 ? ')' : ']';
+		}
+		if (i != terms - 1) {
+			formula += i % 3 == 2 ? groupsOperators[(i / 3) % groupsOperators.size()] : "+*"[i % 3];
+		}
+	}
+	return formula;
+}
+
+// average duration of a call, in microseconds
+template<typename Function>
+static double measure(Function function, std::size_t iterations) {
+	const auto begin{ std::chrono::steady_clock::now() };
+	for (std::size_t i{}; i < iterations; i++) {
+		function();
+	}
+	const std::chrono::duration<double, std::micro> duration{ std::chrono::steady_clock::now() - begin };
+	return duration.count() / static_cast<double>(iterations);
+}
+
+int main() {
+	std::cout << "terms\tshunting-yard (us)\tprevious parser (us)\tspeedup" << std::endl;
+
+	for (const std::size_t terms : { 10, 100, 1'000, 10'000 }) {
+		std::pmr::string formula{};
+		std::pmr::string simplifiedFormula{};
+		addImplicitMultiplyOperators(longFormula(terms), formula);
+		simplifyOperators(formula, simplifiedFormula);
+		std::pmr::vector<Token> tokens{};
+		tokenize(simplifiedFormula, tokens);
+
+		const auto iterations{ std::max<std::size_t>(100'000 / terms / terms, 1) };
+
+		if (evaluate(::parse(tokens)) != evaluate(legacy::parse(tokens))) {
+			std::cerr << "Parsers disagree on a " << terms << " terms formula !" << std::endl;
+			return 1;
+		}
+
+		const auto shuntingYard{ measure([&tokens] { const auto expression{ ::parse(tokens) }; evaluationArena.reset(); return expression; }, iterations * 100) };
+		const auto previous{ measure([&tokens] { return legacy::parse(tokens); }, iterations) };
+		std::cout << terms << '\t' << shuntingYard << "\t\t\t" << previous << "\t\t\t" << previous / shuntingYard << std::endl;
+	}
+	return 0;
+}
\ No newline at end of file
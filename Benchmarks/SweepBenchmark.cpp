@@ -0,0 +1,44 @@
+// compares tabulating a formula line by line ('set' then the formula, for each value) with the 'sweep' command
+// build : the 'sweep_benchmark' CMake target
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "Input.hpp"
+#include "Number.hpp"
+#include "Output.hpp"
+
+int main() {
+	constexpr std::string_view formula{ "3x^2 - 2x / (x + 1) + [x - 0.5] * pi" };
+	constexpr std::size_t values{ 100'000 };
+	constexpr Number step{ Number{ 0.001 } };
+
+	std::ostream discardedOutput{ nullptr };
+	const OutputRedirection redirection{ discardedOutput };
+
+	const auto measure = [](const auto& function) {
+		const auto begin{ std::chrono::steady_clock::now() };
+		function();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	};
+
+	std::string input{};
+	const auto lineByLineDuration{ measure([&input, &formula] {
+		for (std::size_t i{}; i < values; i++) {
+			input = "set x " + std::to_string(static_cast<double>(static_cast<Number>(i) * step));
+			processInput(input);
+			input.assign(formula);
+			processInput(input);
+		}
+	}) };
+
+	const auto sweepDuration{ measure([&input, &formula] {
+		input = "sweep x 0 " + std::to_string(static_cast<double>(static_cast<Number>(values - 1) * step)) + " " + std::to_string(static_cast<double>(step)) + " " + std::string{ formula };
+		processInput(input);
+	}) };
+
+	std::cout << "values\tline by line (s)\tsweep (s)\tspeedup" << std::endl;
+	std::cout << values << '\t' << lineByLineDuration << "\t\t" << sweepDuration << '\t' << lineByLineDuration / sweepDuration << std::endl;
+	return 0;
+}
\ No newline at end of file
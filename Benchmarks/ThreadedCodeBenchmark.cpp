@@ -0,0 +1,68 @@
+// compares evaluating an expression node by node with running its threaded code, on formulas using variables
+// build : the 'threaded_code_benchmark' CMake target
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "EvaluationArena.hpp"
+#include "Expression.hpp"
+#include "Result.hpp"
+#include "ThreadedCode.hpp"
+
+// "a+b*2-c/3*a..." with 'terms' operands, half of them variables, so that nothing can be folded
+static std::string variablesFormula(std::size_t terms) {
+	constexpr std::string_view operandsVariables{ "abc" };
+	constexpr std::string_view termsOperators{ "+*-/*+" };
+	std::string formula{};
+
+	for (std::size_t i{}; i < terms; i++) {
+		if (i % 2 == 0) {
+			formula += operandsVariables[(i / 2) % operandsVariables.size()];
+		}
+		else {
+			formula += std::to_string(i % 9 + 1);
+		}
+		if (i != terms - 1) {
+			formula += termsOperators[i % termsOperators.size()];
+		}
+	}
+	return formula;
+}
+
+// average duration of a call, in nanoseconds
+template<typename Function>
+static double measure(Function function, std::size_t iterations) {
+	const auto begin{ std::chrono::steady_clock::now() };
+	for (std::size_t i{}; i < iterations; i++) {
+		function();
+	}
+	const std::chrono::duration<double, std::nano> duration{ std::chrono::steady_clock::now() - begin };
+	return duration.count() / static_cast<double>(iterations);
+}
+
+int main() {
+	variables.set("a", toValue(Number{ 1.5 }));
+	variables.set("b", integerValue(2));
+	variables.set("c", toValue(Number{ 0.75 }));
+
+	std::cout << "nodes\ttree-walking (ns)\tthreaded code (ns)\tspeedup" << std::endl;
+
+	for (const std::size_t terms : { 5, 50, 500, 5'000 }) {
+		const auto expression{ compile(variablesFormula(terms)) };
+		const ThreadedCode threadedCode{ expression };
+		evaluationArena.reset();
+
+		if (evaluate(expression) != threadedCode.run()) {
+			std::cerr << "Tree-walking and threaded code disagree on a " << expression.nodes.size() << " nodes expression !" << std::endl;
+			return 1;
+		}
+
+		const auto iterations{ 10'000'000 / terms };
+		volatile Number sink{};
+		const auto treeWalking{ measure([&expression, &sink] { sink = toNumber(std::get<Value>(evaluate(expression))); evaluationArena.reset(); }, iterations) };
+		const auto threaded{ measure([&threadedCode, &sink] { sink = toNumber(std::get<Value>(threadedCode.run())); evaluationArena.reset(); }, iterations) };
+		std::cout << expression.nodes.size() << '\t' << treeWalking << "\t\t\t" << threaded << "\t\t\t" << treeWalking / threaded << std::endl;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -1,372 +1,917 @@
-#include "Commands.hpp"
-#include "SyntaxChecking.hpp"
-#include "ErrorsLogging.hpp"
-#include "Result.hpp"
-#include <algorithm>
-#include <sstream>
-#include <fstream>
-#include <numbers>
-#include <functional>
-#include <filesystem>
-#include <iostream>
-
-void help() {
-	const auto waitInput = [] {
-		std::cout << "--- Next ---";
-		std::getchar();
-		std::cout << "\x1b[2K"; // deletes current line (the "--- Next ---' msg)
-		std::cout << "\x1b[1A"; // moves to the beginning of the line
-		std::cout << "\x1b[2K"; // deletes current line
-	};
-
-	constexpr std::array<std::string_view, 39> helpMsg{
-
-	"'help' displays this menu",
-	"'quit' exits the app\n",
-	"Supported features :",
-		"\t- Operators +-*/%^",
-		"\t\tNote : % only accepts two integer operands => '5 % 2' is valid whereas '1.2 % 5' and '8 % 3.6' aren't",
-		"\t\tNote : / and % only accepts a non-zero right operand => '0 / 4' and '3 % 7' are valid whereas '1 / 0' and '2 % 0' aren't\n",
-		"\t- Parethesises () and square brackets []",
-		"\t\tNote : you can mix them => '(1 + 1) * [2 + 2]' is valid",
-		"\t\tNote : implicit multiplications are supported",
-		"\t\tExample : '3(4)', '(4)[5]', and '(5)7' are respectively evaluated as '3*(4)', '(4)*[5]' and '(5)*7'\n",
-		"\t- Mathematical constants pi and e",
-		"\t\tNote : implicit multiplications are supported",
-		"\t\tExample : '3pi' and 'e4' are respectively evaluated as '3*pi' and 'e*4'\n",
-		"\t- Commands : 'set', 'reset', 'save', 'load', 'list', 'savelist'\n",
-		"\t- Variables creation/modification :",
-		"\t\t-> 'set <name> [<value>]' creates (or modifies, if exists at the call) the <name> variable",
-		"\t\tNote : if <value> isn't specified, <name> is set to 0",
-		"\t\tNote : <name> must be compound of only letters (a-z and/or A-Z) and underscores (_)",
-		"\t\tNote : variables may be more than 1 character long, so implicit product of two variables isn't supported :",
-		"\t\t\tExample : let a, b and ab three variables, then inputting 'ab' is ambiguous because it may refer to the 'ab' variable or the implicit product 'a*b'",
-		"\t\tNote : <name> mustn't be a command or a constant identifier",
-		"\t\tExample : 'set A 20' and 'set B' are valid whereas 'set save' and 'set pi 12' aren't\n",
-		"\t- Variables deletion :",
-		"\t\t-> 'reset [<varlist>]' removes <varlist>",
-		"\t\tNote : if <varlist> isn't specified, all variables (except constants) are removed",
-		"\t\tNote : if <varlist> contains at least one non-existing identifier, a warning will be displayed but the process continues if there are other variables",
-		"\t\tExample : 'reset r' and 'reset' are valid whereas 'reset 1' isn't and 'reset pi e' will raise a warning\n",
-		"\t- Saving variables :",
-		"\t\t-> 'save [<varlist>]' copies <varlist> into a save file ('vars.txt')",
-		"\t\tNote : if <varlist> isn't specified, all variables (except constants) are saved",
-		"\t\tExample : if 'a' is set before, then 'save a' is valid, otherwise not\n",
-		"\t- Loading variables :",
-		"\t\t-> 'load [<varlist>]' reads <varlist> from 'vars.txt' and overwrites corresponding variables",
-		"\t\tNote : if <varlist> contains at least one variable which isn't saved, then a warning is emitted for each one",
-		"\t\tNote : a warning is emitted for each variable encountered in 'vars.txt' but not requested in <varlist>\n",
-		"\t- Listing existing variables :",
-		"\t\t-> 'list' displays all the existing variables\n",
-		"\t- Listing saved variables :",
-		"\t\t-> 'savelist' displays all saved variables\n",
-	};
-
-	for (const auto& helpLine : helpMsg) {
-		std::cout << helpLine << std::endl;
-		waitInput();
-	}
-}
-
-std::map<std::string, long double> variables{
-	{"e", std::numbers::e_v<long double>},
-	{"pi", std::numbers::pi_v<long double>}
-};
-
-bool isCommand(const std::string& formula) {
-	for (const auto& command : commands) {
-		if (formula.size() == command.size()) {
-			if (formula == command) {
-				return true;
-			}
-			continue;
-		}
-
-		// checks if the character right after the command is a space
-		if (formula.starts_with(command)) {
-			if (std::isspace(formula[command.size()])) {
-				return true;
-			}
-		}
-	}
-	return false;
-}
-
-// assumes formula is a well-formed command
-CommandArgs getArgs(const std::string& formula) {
-	CommandArgs args{};
-	std::istringstream sstream{ formula };
-	std::string command{};
-	sstream >> command;
-	args.push_back(command);
-
-	std::string elem{};
-	std::size_t count{};
-	while (!sstream.eof()) {
-		if (command == "set" && count == 1) { // the value can be written with space chars
-			std::getline(sstream, elem);
-			do {
-				elem.erase(elem.cbegin());
-			} while (std::isspace(elem[0]));
-
-			args.push_back(elem);
-			break;
-		}
-
-		const std::string previousElem{ elem };
-		sstream >> elem;
-
-		if (elem == previousElem) { // the formula ends with space characters
-			break;
-		}
-		args.push_back(elem);
-		count++;
-	}
-
-	return args;
-}
-
-// assumes command is correct
-bool hasCommandTheRightNumberOfArgs(const std::string& formula) {
-	const auto args{ getArgs(formula) };
-	if (args[0] == "list" || args[0] == "savelist") {
-		return args.size() == 1; // these commands don't take any argument
-	}
-
-	if (args[0] == "set") {
-		return args.size() == 1 || args.size() == 2;
-	}
-
-	// "reset", "save", or "load"
-	return true;
-}
-
-bool isReservedIdentifier(const std::string& identifier) {
-	return std::find(commands.cbegin(), commands.cend(), identifier) != commands.cend() ||
-		std::find(reservedIdentifiers.cbegin(), reservedIdentifiers.cend(), identifier) != reservedIdentifiers.cend();
-}
-
-bool isValidVariableName(const std::string& identifier) {
-	const bool isNotReserved{ !isReservedIdentifier(identifier) };
-	const bool isValidIdentifier{ std::find_if_not(identifier.cbegin(), identifier.cend(), [](char c) {return std::isalpha(c) || c == '_'; }) == identifier.cend() };
-	return isNotReserved && isValidIdentifier;
-}
-
-// assumes the command has the right number of arguments
-std::optional<SyntaxErrorDetails> checkArguments(const std::string& formula) {
-	const auto args{ getArgs(formula) };
-	SyntaxErrorIndexes errors{};
-
-	if (args[0] == "list" || args[0] == "savelist") { // no arguments to check
-		if (args.size() > 1) {
-			for (std::size_t i{ 1 }; i < args.size(); i++) {
-				errors.push_back(i);
-			}
-			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
-		}
-		return std::nullopt;
-	}
-
-	if (args[0] == "reset" || args[0] == "save") { // variable number of arguments which must be valid existing identifiers
-		for (std::size_t i{ 1 }; i < args.size(); i++) {
-			if (variables.find(args[i]) == variables.cend()) { // variable identifier not found
-				errors.push_back(i);
-			}
-		}
-		if (errors.empty()) {
-			return std::nullopt;
-		}
-		return SyntaxErrorDetails{ Error::UnknownIndentifier, errors };
-	}
-
-	if (args[0] == "set") {
-		if (args.size() == 1) {
-			return SyntaxErrorDetails{ Error::MissingVariableName, {} };
-		}
-
-		if (!isValidVariableName(args[1])) {
-			return SyntaxErrorDetails{ Error::BadVariableName, {1} };
-		}
-
-		return std::nullopt;
-	}
-
-	// args[0] == "load"
-	if (!std::filesystem::exists("vars.txt")) {
-		return SyntaxErrorDetails{ Error::NoSaveFile, {} };
-	}
-
-	if (args.size() == 1) {
-		return std::nullopt;
-	}
-
-	for (std::size_t i{ 1 }; i < args.size(); i++) {
-		if (!isValidVariableName(args[i])) {
-			errors.push_back(i);
-		}
-	}
-
-	if (!errors.empty()) {
-		return SyntaxErrorDetails{ Error::BadVariableName, errors };
-	}
-
-	return std::nullopt;
-}
-
-void command::set(const CommandArgs& args) {
-	if (args.size() == 2) {
-		variables[args[1]] = 0.L;
-	}
-	else {
-		if (!isSyntaxCorrect(args[2])) {
-			std::cerr << "Bad value syntax :" << std::endl;
-			checkSyntax(args[2]);
-			return;
-		}
-
-		const auto resultValue{ result(args[2]) };
-		if (!resultValue.has_value()) {
-			std::cerr << "Failed to evaluate value, variable \"" << args[1] << "\" remains unchanged." << std::endl;
-			return;
-		}
-
-		variables[args[1]] = resultValue.value();
-	}
-}
-
-void command::reset(const CommandArgs& args) {
-	if (args.size() == 1) {
-		variables = {
-			{"e", std::numbers::e_v<long double>},
-			{"pi", std::numbers::pi_v<long double>}
-		};
-	}
-	else {
-		for (std::size_t i{ 1 }; i < args.size(); i++) {
-			variables.erase(args[i]);
-		}
-	}
-}
-
-void command::load(const CommandArgs& args) {
-	std::ifstream vars{ "vars.txt" };
-	if (!vars) {
-		std::cerr << "Unexpected error while trying to read save file 'vars.txt' !" << std::endl;
-		return;
-	}
-
-	std::pair<std::string, long double> var{};
-	std::vector<std::string> varsLoaded{};
-	std::string previousVarName{};
-
-	while (true) {
-		vars >> var.first >> var.second;
-		if (previousVarName == var.first) { // input didn't change "var"'s value, end of file reached
-			break;
-		}
-		previousVarName = var.first;
-
-		if (!isReservedIdentifier(var.first)) {
-			if (args.size() == 1) { // loads all
-				variables[var.first] = var.second;
-				continue;
-			}
-
-			if (std::find(args.cbegin() + 1, args.cend(), var.first) != args.cend()) { // variable to load
-				variables[var.first] = var.second;
-				varsLoaded.push_back(var.first);
-				continue;
-			}
-
-			std::clog << "[Warning] Variable \"" << var.first << "\" read in file 'vars.txt', but not in the command arguments, so isn't loaded." << std::endl;
-		}
-	}
-
-	if (args.size() > 1 && varsLoaded.size() != (args.size() - 1)) { // if there are less read variables than given in the args
-		for (std::size_t i{ 1 }; i < args.size(); i++) {
-			if (std::find(varsLoaded.cbegin(), varsLoaded.cend(), args[i]) == varsLoaded.cend()) { // var in the args weren't in save file
-				std::clog << "[Warning] : Variable \"" << args[i] << "\" isn't saved in file 'vars.txt', its value remains the same." << std::endl;
-			}
-		}
-	}
-}
-
-void command::save(const CommandArgs& args) {
-	std::ofstream vars{ "vars.txt" };
-	if (!vars) {
-		std::cerr << "Unexpected error while trying to write into save file 'vars.txt' !" << std::endl;
-		return;
-	}
-
-	if (args.size() == 1) { // saves all
-		for (const auto& var : variables) {
-			if (!isReservedIdentifier(var.first)) {
-				vars << var.first << ' ' << var.second << std::endl;
-			}
-		}
-		return;
-	}
-
-	for (std::size_t i{ 1 }; i < args.size(); i++) {
-		if (!isReservedIdentifier(args[i])) {
-			vars << args[i] << ' ' << variables.at(args[i]) << std::endl;
-		}
-		else {
-			std::clog << "[Warning] \"" << args[i] << "\" is a constant and wasn't saved into 'vars.txt'" << std::endl;
-		}
-	}
-}
-
-void command::list([[maybe_unused]] const CommandArgs& args) {
-	for (const auto& var : variables) {
-		if (isReservedIdentifier(var.first)) {
-			std::cout << "[Reserved] ";
-		}
-		std::cout << var.first << " = " << var.second << std::endl;
-	}
-	std::cout << std::endl;
-}
-
-void command::savelist([[maybe_unused]] const CommandArgs& args) {
-	std::ifstream vars{ "vars.txt" };
-	if (!vars) {
-		std::cerr << "Unexpected error while trying to read save file 'vars.txt' !" << std::endl;
-		return;
-	}
-
-	std::pair<std::string, long double> var{};
-	std::string previousVarName{};
-
-	while (true) {
-		vars >> var.first >> var.second;
-		if (previousVarName == var.first) { // input didn't change "var"'s value, end of file reached
-			break;
-		}
-		previousVarName = var.first;
-
-		if (isReservedIdentifier(var.first)) {
-			std::cout << "[Reserved] ";
-		}
-		std::cout << var.first << " = " << var.second << std::endl;
-	}
-}
-
-void executeCommand(const std::string& formula) {
-	using funcType = decltype(std::function(command::set));
-
-	std::map<std::string, funcType> commandsMap{
-		{"set", command::set},
-		{"reset", command::reset},
-		{"load", command::load},
-		{"save", command::save},
-		{"list", command::list},
-		{"savelist", command::savelist}
-	};
-
-	for (const auto& command : commandsMap) {
-		if (getArgs(formula)[0] == command.first) {
-			command.second(getArgs(formula));
-			break;
-		}
-	}
+#include "Commands.hpp"
+#include "SyntaxChecking.hpp"
+#include "ErrorsLogging.hpp"
+#include "Result.hpp"
+#include "ExpressionCache.hpp"
+#include "FunctionTable.hpp"
+#include "SymbolTable.hpp"
+#include "SaveFile.hpp"
+#include "Journal.hpp"
+#include "DependencyGraph.hpp"
+#include "EvaluationArena.hpp"
+#include "PipelineStatistics.hpp"
+#include "Output.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+void help(bool paginate) {
+	const auto waitInput = [] {
+		std::cout << "--- Next ---";
+		std::getchar();
+		std::cout << "\x1b[2K"; // deletes current line (the "--- Next ---' msg)
+		std::cout << "\x1b[1A"; // moves to the beginning of the line
+		std::cout << "\x1b[2K"; // deletes current line
+	};
+
+	constexpr std::array<std::string_view, 74> helpMsg{
+
+	"'help' displays this menu",
+	"'quit' exits the app\n",
+	"Supported features :",
+		"\t- Operators +-*/%^",
+		"\t\tNote : % only accepts two integer operands => '5 % 2' is valid whereas '1.2 % 5' and '8 % 3.6' aren't",
+		"\t\tNote : / and % only accepts a non-zero right operand => '0 / 4' and '3 % 7' are valid whereas '1 / 0' and '2 % 0' aren't\n",
+		"\t- Parethesises () and square brackets []",
+		"\t\tNote : you can mix them => '(1 + 1) * [2 + 2]' is valid",
+		"\t\tNote : implicit multiplications are supported",
+		"\t\tExample : '3(4)', '(4)[5]', and '(5)7' are respectively evaluated as '3*(4)', '(4)*[5]' and '(5)*7'\n",
+		"\t- Mathematical constants pi and e",
+		"\t\tNote : implicit multiplications are supported",
+		"\t\tExample : '3pi' and 'e4' are respectively evaluated as '3*pi' and 'e*4'\n",
+		"\t- Commands : 'set', 'bind', 'def', 'sweep', 'reset', 'save', 'savetext', 'load', 'list', 'savelist', 'journal', 'cache', 'nesting', 'stats'\n",
+		"\t- Variables creation/modification :",
+		"\t\t-> 'set <name> [<value>]' creates (or modifies, if exists at the call) the <name> variable",
+		"\t\tNote : if <value> isn't specified, <name> is set to 0",
+		"\t\tNote : <name> must be compound of only letters (a-z and/or A-Z) and underscores (_)",
+		"\t\tNote : variables may be more than 1 character long, so implicit product of two variables isn't supported :",
+		"\t\t\tExample : let a, b and ab three variables, then inputting 'ab' is ambiguous because it may refer to the 'ab' variable or the implicit product 'a*b'",
+		"\t\tNote : <name> mustn't be a command or a constant identifier",
+		"\t\tExample : 'set A 20' and 'set B' are valid whereas 'set save' and 'set pi 12' aren't\n",
+		"\t- Variables bound to a formula :",
+		"\t\t-> 'bind <name> <formula>' creates (or modifies) the <name> variable, which is recomputed whenever a variable used by <formula> changes",
+		"\t\tNote : 'set' or 'load' on a bound variable unbinds it, 'reset' on a variable used by others unbinds them, they keep their last value",
+		"\t\tNote : a variable can't depend on itself, even indirectly",
+		"\t\tExample : after 'bind total a + b', 'set a 5' updates total whereas 'bind a total' is invalid\n",
+		"\t- Functions :",
+		"\t\t-> 'def <name>(<parameters>) = <formula>' creates (or replaces) the <name> function, called as '<name>(<arguments>)'",
+		"\t\tNote : parameters and arguments are separated by ',', <formula> may use the parameters, variables and functions",
+		"\t\tNote : a function is compiled once, and its formula is copied where it is called, so a call costs as much as the formula itself",
+		"\t\tNote : a function keeps the formulas of the functions it calls, even if they are replaced afterwards",
+		"\t\tExample : after 'def hypot(a, b) = (a^2 + b^2)^0.5', 'hypot(3, 4)' is 5 whereas 'hypot(3)' is invalid\n",
+		"\t- Tabulating a formula :",
+		"\t\t-> 'sweep <name> <from> <to> <step> <formula>' displays <name> and the value of <formula> for <name> going from <from> to <to> by <step>",
+		"\t\tNote : <name> is restored (or removed if it didn't exist) after the sweep, and variables bound to it aren't recomputed",
+		"\t\tExample : 'sweep x 0 1 0.25 x^2' and 'sweep t 10 0 -2 2t' are valid whereas 'sweep x 0 1 -0.5 x' isn't\n",
+		"\t- Variables deletion :",
+		"\t\t-> 'reset [<varlist>]' removes <varlist>",
+		"\t\tNote : if <varlist> isn't specified, all variables (except constants) are removed",
+		"\t\tNote : if <varlist> contains at least one non-existing identifier, a warning will be displayed but the process continues if there are other variables",
+		"\t\tExample : 'reset r' and 'reset' are valid whereas 'reset 1' isn't and 'reset pi e' will raise a warning\n",
+		"\t- Saving variables :",
+		"\t\t-> 'save [<varlist>]' copies <varlist> into a binary save file ('vars.bin')",
+		"\t\t-> 'savetext [<varlist>]' copies <varlist> into a text save file ('vars.txt')",
+		"\t\tNote : if <varlist> isn't specified, all variables (except constants) are saved",
+		"\t\tNote : a save replaces the previous one, whatever its format",
+		"\t\tExample : if 'a' is set before, then 'save a' is valid, otherwise not\n",
+		"\t- Loading variables :",
+		"\t\t-> 'load [<varlist>]' reads <varlist> from the save file ('vars.bin' or 'vars.txt') and overwrites corresponding variables",
+		"\t\tNote : if <varlist> contains at least one variable which isn't saved, then a warning is emitted for each one",
+		"\t\tNote : a warning is emitted for each variable encountered in the save file but not requested in <varlist>\n",
+		"\t- Journal :",
+		"\t\t-> 'journal [on|off]' displays the journal status, or starts or stops saving the variables each time they are modified",
+		"\t\tNote : 'journal on' saves all variables into 'vars.bin', then each command appends the variables it modified to 'vars.log', merged into 'vars.bin' in the background as it grows",
+		"\t\tNote : the journal is resumed at startup, 'load' and 'savelist' read 'vars.bin' modified by 'vars.log', whereas 'save' and 'savetext' stop it",
+		"\t\tNote : only the values are saved, not the formulas variables are bound to nor the functions",
+		"\t\tExample : 'journal', 'journal on' and 'journal off' are valid whereas 'journal 1' isn't\n",
+		"\t- Listing existing variables :",
+		"\t\t-> 'list' displays all the existing variables, then the functions\n",
+		"\t- Listing saved variables :",
+		"\t\t-> 'savelist' displays all saved variables\n",
+		"\t- Compiled formulas cache :",
+		"\t\t-> 'cache [<capacity>]' displays the cache statistics, or sets how many compiled formulas are kept",
+		"\t\tNote : <capacity> must be a non-negative integer, 0 disables the cache",
+		"\t\tExample : 'cache' and 'cache 100' are valid whereas 'cache -1' and 'cache 2.5' aren't\n",
+		"\t- Nesting limit :",
+		"\t\t-> 'nesting [<limit>]' displays or sets how deeply parenthesises and square brackets may be nested in a formula",
+		"\t\tNote : <limit> must be a positive integer, it is 1000000 by default and bounds the memory used by a formula",
+		"\t\tExample : 'nesting' and 'nesting 5000' are valid whereas 'nesting 0' and 'nesting -1' aren't\n",
+		"\t- Pipeline statistics :",
+		"\t\t-> 'stats' displays the number of calls, the cumulated duration and the allocated bytes of each evaluation stage,",
+		"\t\tand how many nodes were shared by the compiled formulas, as they were identical to other ones",
+		"\t\t-> 'stats reset' sets them back to 0\n",
+	};
+
+	for (const auto& helpLine : helpMsg) {
+		if (!paginate) {
+			output() << helpLine << '\n';
+			continue;
+		}
+		std::cout << helpLine << std::endl;
+		waitInput();
+	}
+}
+
+// FNV-1a, whose offset basis is changed by seed
+static constexpr std::uint32_t commandHash(std::string_view name, std::uint32_t seed) noexcept {
+	auto hash{ 2166136261u ^ seed };
+	for (const auto c : name) {
+		hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+	}
+	return hash;
+}
+
+constexpr std::size_t commandBucketsCount{ 32 };
+
+// first seed for which each command has its own bucket
+static constexpr std::uint32_t findCommandHashSeed() {
+	for (std::uint32_t seed{};; seed++) {
+		std::array<bool, commandBucketsCount> usedBuckets{};
+		bool collision{};
+		for (const auto command : commands) {
+			auto& used{ usedBuckets[commandHash(command, seed) % commandBucketsCount] };
+			collision = collision || used;
+			used = true;
+		}
+		if (!collision) {
+			return seed;
+		}
+	}
+}
+
+constexpr std::uint32_t commandHashSeed{ findCommandHashSeed() };
+
+// index in 'commands' of the command of each bucket, commands.size() for empty buckets
+constexpr auto commandBuckets{ [] {
+	std::array<std::size_t, commandBucketsCount> buckets{};
+	buckets.fill(commands.size());
+	for (std::size_t i{}; i < commands.size(); i++) {
+		buckets[commandHash(commands[i], commandHashSeed) % commandBucketsCount] = i;
+	}
+	return buckets;
+}() };
+
+std::optional<std::size_t> findCommand(std::string_view name) noexcept {
+	const auto index{ commandBuckets[commandHash(name, commandHashSeed) % commandBucketsCount] };
+	if (index == commands.size() || commands[index] != name) {
+		return std::nullopt;
+	}
+	return index;
+}
+
+bool isCommand(std::string_view formula) {
+	const auto nameEnd{ std::find_if(formula.cbegin(), formula.cend(), [](char c) { return std::isspace(c); }) };
+	return findCommand(std::string_view{ formula.cbegin(), nameEnd }).has_value();
+}
+
+bool parseCommand(std::string_view formula, CommandArgs& args) {
+	args.clear();
+	if (!isCommand(formula)) {
+		return false;
+	}
+
+	std::size_t i{};
+	const auto skipSpaces = [&formula, &i] {
+		while (i < formula.size() && std::isspace(formula[i])) {
+			i++;
+		}
+	};
+
+	while (i < formula.size()) {
+		if (args.size() == 1 && args[0] == "def") { // the signature and the formula can be written with space chars
+			const auto equal{ std::min(formula.find('=', i), formula.size()) };
+			auto signatureEnd{ equal };
+			while (signatureEnd > i && std::isspace(formula[signatureEnd - 1])) {
+				signatureEnd--;
+			}
+			args.push_back(formula.substr(i, signatureEnd - i));
+
+			i = equal + 1;
+			skipSpaces();
+			if (i < formula.size()) {
+				args.push_back(formula.substr(i));
+			}
+			break;
+		}
+
+		const bool isFormulaArg{ (args.size() == 2 && (args[0] == "set" || args[0] == "bind")) || (args.size() == 5 && args[0] == "sweep") };
+		if (isFormulaArg) { // the value can be written with space chars
+			args.push_back(formula.substr(i));
+			break;
+		}
+
+		const auto argBegin{ i };
+		while (i < formula.size() && !std::isspace(formula[i])) {
+			i++;
+		}
+		args.push_back(formula.substr(argBegin, i - argBegin));
+		skipSpaces();
+	}
+
+	return true;
+}
+
+// assumes command is correct
+bool hasCommandTheRightNumberOfArgs(const CommandArgs& args) {
+	if (args[0] == "list" || args[0] == "savelist") {
+		return args.size() == 1; // these commands don't take any argument
+	}
+
+	if (args[0] == "set" || args[0] == "journal" || args[0] == "cache" || args[0] == "nesting") {
+		return args.size() == 1 || args.size() == 2;
+	}
+
+	if (args[0] == "def") {
+		return args.size() == 3;
+	}
+
+	// "reset", "save", "savetext", or "load"
+	return true;
+}
+
+bool isReservedIdentifier(std::string_view identifier) {
+	return std::find(commands.cbegin(), commands.cend(), identifier) != commands.cend() ||
+		std::find(reservedIdentifiers.cbegin(), reservedIdentifiers.cend(), identifier) != reservedIdentifiers.cend();
+}
+
+// not reserved, and only made of letters and underscores
+static bool isValidName(std::string_view identifier) {
+	const bool isNotReserved{ !isReservedIdentifier(identifier) };
+	const bool isValidIdentifier{ std::find_if_not(identifier.cbegin(), identifier.cend(), [](char c) {return std::isalpha(c) || c == '_'; }) == identifier.cend() };
+	return isNotReserved && isValidIdentifier;
+}
+
+bool isValidVariableName(std::string_view identifier) {
+	return isValidName(identifier) && !functions.contains(identifier);
+}
+
+bool isValidFunctionName(std::string_view identifier) {
+	return !identifier.empty() && isValidName(identifier) && !variables.contains(identifier);
+}
+
+std::optional<FunctionSignature> parseFunctionSignature(std::string_view signature) {
+	const auto trimSpaces = [](std::string_view text) {
+		while (!text.empty() && std::isspace(text.front())) {
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && std::isspace(text.back())) {
+			text.remove_suffix(1);
+		}
+		return text;
+	};
+
+	const auto parametersBegin{ signature.find('(') };
+	if (parametersBegin == std::string_view::npos || !signature.ends_with(')')) {
+		return std::nullopt;
+	}
+
+	FunctionSignature parsedSignature{ .name = trimSpaces(signature.substr(0, parametersBegin)) };
+	auto parameters{ signature.substr(parametersBegin + 1, signature.size() - parametersBegin - 2) };
+	while (true) {
+		const auto separator{ std::min(parameters.find(','), parameters.size()) };
+		const auto parameter{ trimSpaces(parameters.substr(0, separator)) };
+		const bool isValidParameter{
+			!parameter.empty() && isValidName(parameter) && !functions.contains(parameter) &&
+			std::find(parsedSignature.parameters.cbegin(), parsedSignature.parameters.cend(), parameter) == parsedSignature.parameters.cend()
+		};
+		if (!isValidParameter) {
+			return std::nullopt;
+		}
+		parsedSignature.parameters.push_back(parameter);
+
+		if (separator == parameters.size()) {
+			break;
+		}
+		parameters.remove_prefix(separator + 1);
+	}
+
+	if (!isValidFunctionName(parsedSignature.name) || parsedSignature.parameters.size() > maxParameters) {
+		return std::nullopt;
+	}
+	return parsedSignature;
+}
+
+std::optional<std::size_t> parseCacheCapacity(std::string_view arg) {
+	std::size_t capacity{};
+	const auto [end, error] { std::from_chars(arg.data(), arg.data() + arg.size(), capacity) };
+	if (error != std::errc{} || end != arg.data() + arg.size()) {
+		return std::nullopt;
+	}
+	return capacity;
+}
+
+std::optional<std::size_t> parseNestingLimit(std::string_view arg) {
+	const auto limit{ parseCacheCapacity(arg) };
+	if (!limit.has_value() || limit.value() == 0) {
+		return std::nullopt;
+	}
+	return limit;
+}
+
+std::optional<Number> parseSweepBound(std::string_view arg) {
+	Number bound{};
+	const auto [end, error] { number::fromChars(arg.data(), arg.data() + arg.size(), bound) };
+	if (error != std::errc{} || end != arg.data() + arg.size() || !number::isfinite(bound)) {
+		return std::nullopt;
+	}
+	return bound;
+}
+
+std::optional<std::size_t> sweepValuesCount(Number from, Number to, Number step) {
+	const auto steps{ (to - from) / step };
+	if (step == 0 || !number::isfinite(steps) || steps < 0 || steps >= static_cast<Number>(std::numeric_limits<std::size_t>::max())) {
+		return std::nullopt;
+	}
+	// tolerates rounding errors, so that 'to' is reached for instance from 0 to 1 with a step of 0.1
+	return static_cast<std::size_t>(number::floor(steps + Number{ 1e-9 })) + 1;
+}
+
+// slots of the variables used by a formula, including the ones used by the functions it calls
+// assumes syntax was checked previously
+static std::vector<SymbolTable::Slot> formulaVariables(std::string_view formula) {
+	std::vector<SymbolTable::Slot> slots{};
+	const auto isIdentifierCharacter = [](char c) { return std::isalpha(c) || c == '_'; };
+
+	for (auto identifierBegin{ std::find_if(formula.cbegin(), formula.cend(), isIdentifierCharacter) }; identifierBegin != formula.cend();) {
+		const auto identifierEnd{ std::find_if_not(identifierBegin, formula.cend(), isIdentifierCharacter) };
+		const std::string_view identifier{ identifierBegin, identifierEnd };
+		if (const auto slot{ variables.find(identifier) }; slot.has_value()) {
+			slots.push_back(slot.value());
+		}
+		else if (const auto function{ functions.find(identifier) }; function.has_value()) {
+			const auto& functionVariables{ functions.function(function.value()).variables };
+			slots.insert(slots.end(), functionVariables.cbegin(), functionVariables.cend());
+		}
+		identifierBegin = std::find_if(identifierEnd, formula.cend(), isIdentifierCharacter);
+	}
+	return slots;
+}
+
+std::optional<SyntaxErrorDetails> checkArguments(const CommandArgs& args) {
+	SyntaxErrorIndexes errors{};
+
+	if (args[0] == "list" || args[0] == "savelist") { // no arguments to check
+		if (args.size() > 1) {
+			for (std::size_t i{ 1 }; i < args.size(); i++) {
+				errors.push_back(i);
+			}
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
+		}
+		return std::nullopt;
+	}
+
+	if (args[0] == "reset" || args[0] == "save" || args[0] == "savetext") { // variable number of arguments which must be valid existing identifiers
+		for (std::size_t i{ 1 }; i < args.size(); i++) {
+			if (!variables.contains(args[i])) { // variable identifier not found
+				errors.push_back(i);
+			}
+		}
+		if (errors.empty()) {
+			return std::nullopt;
+		}
+		return SyntaxErrorDetails{ Error::UnknownIndentifier, errors };
+	}
+
+	if (args[0] == "set") {
+		if (args.size() == 1) {
+			return SyntaxErrorDetails{ Error::MissingVariableName, {} };
+		}
+
+		if (!isValidVariableName(args[1])) {
+			return SyntaxErrorDetails{ Error::BadVariableName, {1} };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "bind") {
+		if (args.size() == 1) {
+			return SyntaxErrorDetails{ Error::MissingVariableName, {} };
+		}
+
+		if (!isValidVariableName(args[1])) {
+			return SyntaxErrorDetails{ Error::BadVariableName, {1} };
+		}
+
+		if (args.size() == 2) {
+			return SyntaxErrorDetails{ Error::MissingFormula, {} };
+		}
+
+		// the syntax of the formula is checked by the command itself, as for 'set'
+		// a removed variable keeps its slot, which must not be reachable from the formula either
+		const auto variable{ variables.findInterned(args[1]) };
+		if (variable.has_value() && isSyntaxCorrect(args[2]) && dependencyGraph.createsCycle(variable.value(), formulaVariables(args[2]))) {
+			return SyntaxErrorDetails{ Error::CyclicDependency, {2} };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "def") {
+		if (args.size() == 1 || !parseFunctionSignature(args[1]).has_value()) {
+			return SyntaxErrorDetails{ Error::BadFunctionDefinition, args.size() == 1 ? SyntaxErrorIndexes{} : SyntaxErrorIndexes{ 1 } };
+		}
+
+		if (args.size() == 2) {
+			return SyntaxErrorDetails{ Error::MissingFormula, {} };
+		}
+
+		// the syntax of the formula is checked by the command itself, as for 'set'
+		return std::nullopt;
+	}
+
+	if (args[0] == "sweep") {
+		if (args.size() == 1) {
+			return SyntaxErrorDetails{ Error::MissingVariableName, {} };
+		}
+
+		if (!isValidVariableName(args[1])) {
+			return SyntaxErrorDetails{ Error::BadVariableName, {1} };
+		}
+
+		if (args.size() < 6) {
+			return SyntaxErrorDetails{ Error::MissingSweepArguments, {} };
+		}
+
+		std::array<std::optional<Number>, 3> bounds{};
+		for (std::size_t i{ 2 }; i < 5; i++) {
+			bounds[i - 2] = parseSweepBound(args[i]);
+			if (!bounds[i - 2].has_value()) {
+				errors.push_back(i);
+			}
+		}
+		if (errors.empty() && !sweepValuesCount(bounds[0].value(), bounds[1].value(), bounds[2].value()).has_value()) {
+			errors.push_back(4); // the step doesn't go from the first bound to the second one
+		}
+		if (!errors.empty()) {
+			return SyntaxErrorDetails{ Error::BadSweepRange, errors };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "cache") {
+		if (args.size() > 2) {
+			for (std::size_t i{ 2 }; i < args.size(); i++) {
+				errors.push_back(i);
+			}
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
+		}
+
+		if (args.size() == 2 && !parseCacheCapacity(args[1]).has_value()) {
+			return SyntaxErrorDetails{ Error::BadCacheCapacity, {1} };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "nesting") {
+		if (args.size() > 2) {
+			for (std::size_t i{ 2 }; i < args.size(); i++) {
+				errors.push_back(i);
+			}
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
+		}
+
+		if (args.size() == 2 && !parseNestingLimit(args[1]).has_value()) {
+			return SyntaxErrorDetails{ Error::BadNestingLimit, {1} };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "stats") {
+		if (args.size() > 2) {
+			for (std::size_t i{ 2 }; i < args.size(); i++) {
+				errors.push_back(i);
+			}
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
+		}
+
+		if (args.size() == 2 && args[1] != "reset") {
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, {1} };
+		}
+
+		return std::nullopt;
+	}
+
+	if (args[0] == "journal") {
+		if (args.size() > 2) {
+			for (std::size_t i{ 2 }; i < args.size(); i++) {
+				errors.push_back(i);
+			}
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, errors };
+		}
+
+		if (args.size() == 2 && args[1] != "on" && args[1] != "off") {
+			return SyntaxErrorDetails{ Error::UnexpectedArgument, {1} };
+		}
+
+		return std::nullopt;
+	}
+
+	// args[0] == "load"
+	if (!existingSaveFile().has_value()) {
+		return SyntaxErrorDetails{ Error::NoSaveFile, {} };
+	}
+
+	if (args.size() == 1) {
+		return std::nullopt;
+	}
+
+	for (std::size_t i{ 1 }; i < args.size(); i++) {
+		if (!isValidVariableName(args[i])) {
+			errors.push_back(i);
+		}
+	}
+
+	if (!errors.empty()) {
+		return SyntaxErrorDetails{ Error::BadVariableName, errors };
+	}
+
+	return std::nullopt;
+}
+
+// the variable isn't bound to a formula anymore, and the variables depending on it are recomputed
+static void assignVariable(std::string_view name, const Value& value) {
+	const auto slot{ variables.set(name, value) };
+	dependencyGraph.unbind(slot);
+	dependencyGraph.propagate(slot);
+}
+
+void command::set(const CommandArgs& args) {
+	if (args.size() == 2) {
+		assignVariable(args[1], integerValue(0));
+	}
+	else {
+		if (!isSyntaxCorrect(args[2])) {
+			logMessage("Bad value syntax :");
+			checkSyntax(args[2]);
+			return;
+		}
+
+		const auto resultValue{ result(args[2]) };
+		if (const auto error{ std::get_if<Error>(&resultValue) }) {
+			logError(*error, {}, args[2]);
+			logMessage("Failed to evaluate value, variable \"" + std::string{ args[1] } + "\" remains unchanged.");
+			return;
+		}
+
+		assignVariable(args[1], std::get<Value>(resultValue));
+	}
+}
+
+void command::sweep(const CommandArgs& args) {
+	const auto from{ parseSweepBound(args[2]).value() };
+	const auto to{ parseSweepBound(args[3]).value() };
+	const auto step{ parseSweepBound(args[4]).value() };
+	const auto count{ sweepValuesCount(from, to, step).value() };
+
+	// the variable is defined during the sweep, so that the formula can use it, then restored
+	const auto previousSlot{ variables.find(args[1]) };
+	const auto previousValue{ previousSlot.has_value() ? variables.exactValue(previousSlot.value()) : Value{} };
+	const auto slot{ variables.set(args[1], toValue(from)) };
+	const auto restoreVariable = [&] {
+		if (previousSlot.has_value()) {
+			variables.set(slot, previousValue);
+		}
+		else {
+			variables.erase(args[1]);
+		}
+	};
+
+	if (!isSyntaxCorrect(args[5])) {
+		logMessage("Bad formula syntax :");
+		checkSyntax(args[5]);
+		restoreVariable();
+		return;
+	}
+
+	// compiled once, then evaluated batchSize values at a time
+	std::pmr::string formulaWithoutSpaces{ evaluationArena.resource() };
+	removeSpaces(args[5], formulaWithoutSpaces);
+	const auto expression{ compile(formulaWithoutSpaces) };
+
+	std::array<Number, batchSize> values{};
+	std::array<Number, batchSize> results{};
+	std::array<bool, batchSize> failures{};
+
+	for (std::size_t batchBegin{}; batchBegin < count; batchBegin += batchSize) {
+		const auto lanes{ std::min(batchSize, count - batchBegin) };
+		for (std::size_t lane{}; lane < lanes; lane++) {
+			values[lane] = from + static_cast<Number>(batchBegin + lane) * step; // no accumulated rounding error
+		}
+
+		evaluateBatch(expression, slot, { values.data(), lanes }, { results.data(), lanes }, { failures.data(), lanes });
+
+		for (std::size_t lane{}; lane < lanes; lane++) {
+			if (failures[lane]) { // evaluated again, only to know the error
+				variables.set(slot, toValue(values[lane]));
+				if (const auto value{ evaluate(expression) }; std::holds_alternative<Error>(value)) {
+					logError(std::get<Error>(value), {}, args[5]);
+					std::ostringstream variableValue{};
+					writeNumber(variableValue, values[lane]);
+					logMessage("Failed to evaluate formula for " + std::string{ args[1] } + " = " + variableValue.str() + ", no row is written.");
+				}
+				continue;
+			}
+			writeNumber(output(), values[lane]);
+			output() << '\t';
+			writeNumber(output(), results[lane]);
+			output() << '\n';
+		}
+	}
+
+	restoreVariable();
+}
+
+void command::bind(const CommandArgs& args) {
+	if (!isSyntaxCorrect(args[2])) {
+		logMessage("Bad formula syntax :");
+		checkSyntax(args[2]);
+		return;
+	}
+
+	std::pmr::string formulaWithoutSpaces{ evaluationArena.resource() };
+	removeSpaces(args[2], formulaWithoutSpaces);
+	auto expression{ compile(formulaWithoutSpaces) };
+
+	const auto value{ evaluate(expression) };
+	if (const auto error{ std::get_if<Error>(&value) }) {
+		logError(*error, {}, args[2]);
+		logMessage("Failed to evaluate formula, variable \"" + std::string{ args[1] } + "\" remains unchanged.");
+		return;
+	}
+
+	const auto slot{ variables.set(args[1], std::get<Value>(value)) };
+	dependencyGraph.bind(slot, std::string{ args[2] }, std::move(expression));
+	dependencyGraph.propagate(slot);
+}
+
+// the body is compiled once, then inlined by the formulas calling the function, which are compiled again as they may call a previous definition
+void command::def(const CommandArgs& args) {
+	const auto signature{ parseFunctionSignature(args[1]).value() };
+	if (!isSyntaxCorrect(args[2], signature.parameters)) {
+		logMessage("Bad formula syntax :");
+		checkSyntax(args[2], signature.parameters);
+		return;
+	}
+
+	std::pmr::string formulaWithoutSpaces{ evaluationArena.resource() };
+	removeSpaces(args[2], formulaWithoutSpaces);
+	functions.define(signature.name, std::string{ args[1] } + " = " + std::string{ args[2] }, signature.parameters.size(), compile(formulaWithoutSpaces, signature.parameters));
+	ExpressionCache::invalidate();
+}
+
+// removed variables keep their slot, so cached expressions don't need to be invalidated : syntax checking rejects formulas using them
+void command::reset(const CommandArgs& args) {
+	if (args.size() == 1) {
+		variables.reset();
+		dependencyGraph.clear();
+	}
+	else {
+		for (std::size_t i{ 1 }; i < args.size(); i++) {
+			const auto variable{ variables.find(args[i]) };
+			if (!variable.has_value()) { // already removed, as it appears several times in the arguments
+				continue;
+			}
+			dependencyGraph.remove(variable.value()); // variables depending on it are unbound, and keep their last value
+			variables.erase(args[i]);
+		}
+	}
+}
+
+void command::load(const CommandArgs& args) {
+	const auto saveFile{ existingSaveFile() };
+	std::vector<std::string_view> varsLoaded{};
+
+	const auto loadVariable = [&args, &saveFile, &varsLoaded](std::string_view name, Number value) {
+		if (isReservedIdentifier(name)) {
+			return;
+		}
+
+		if (functions.contains(name)) {
+			logMessage("[Warning] Variable \"" + std::string{ name } + "\" read in file '" + saveFile.value() + "', but a function has the same name, so isn't loaded.");
+			return;
+		}
+
+		if (args.size() == 1) { // loads all
+			assignVariable(name, toValue(value));
+			return;
+		}
+
+		if (const auto arg{ std::find(args.cbegin() + 1, args.cend(), name) }; arg != args.cend()) { // variable to load
+			assignVariable(name, toValue(value));
+			varsLoaded.push_back(*arg);
+			return;
+		}
+
+		logMessage("[Warning] Variable \"" + std::string{ name } + "\" read in file '" + saveFile.value() + "', but not in the command arguments, so isn't loaded.");
+	};
+
+	if (!saveFile.has_value() || !readSavedVariables(saveFile.value(), loadVariable)) {
+		logMessage("Unexpected error while trying to read save file '" + saveFile.value_or(std::string{ snapshotFileName }) + "' !");
+		return;
+	}
+
+	if (args.size() > 1 && varsLoaded.size() != (args.size() - 1)) { // if there are less read variables than given in the args
+		for (std::size_t i{ 1 }; i < args.size(); i++) {
+			if (std::find(varsLoaded.cbegin(), varsLoaded.cend(), args[i]) == varsLoaded.cend()) { // var in the args weren't in save file
+				logMessage("[Warning] : Variable \"" + std::string{ args[i] } + "\" isn't saved in file '" + saveFile.value() + "', its value remains the same.");
+			}
+		}
+	}
+}
+
+// variables to write into a save file, all of them (except constants) if there are no arguments
+static std::vector<SavedVariable> variablesToSave(const CommandArgs& args, std::string_view fileName) {
+	std::vector<SavedVariable> varsToSave{};
+
+	if (args.size() == 1) { // saves all, in creation order
+		varsToSave.reserve(variables.slotCount());
+		for (SymbolTable::Slot slot{}; slot < variables.slotCount(); slot++) {
+			if (variables.isDefined(slot) && !isReservedIdentifier(variables.name(slot))) {
+				varsToSave.push_back({ variables.name(slot), variables.value(slot) });
+			}
+		}
+		return varsToSave;
+	}
+
+	for (std::size_t i{ 1 }; i < args.size(); i++) {
+		if (!isReservedIdentifier(args[i])) {
+			varsToSave.push_back({ args[i], variables.value(variables.find(args[i]).value()) });
+		}
+		else {
+			logMessage("[Warning] \"" + std::string{ args[i] } + "\" is a constant and wasn't saved into '" + std::string{ fileName } + "'");
+		}
+	}
+	return varsToSave;
+}
+
+// the journal would modify the new save file, so it is merged into the previous one first
+static void stopJournal(std::string_view fileName) {
+	if (!journal.status().isActive) {
+		return;
+	}
+	if (!journal.stop()) {
+		logMessage("Unexpected error while trying to merge the journal '" + std::string{ journalFileName } + "' !");
+	}
+	logMessage("[Warning] The journal is stopped, as variables are saved into '" + std::string{ fileName } + "'.");
+}
+
+// a save replaces the previous one, whatever its format, so that 'load' always reads the last one
+void command::save(const CommandArgs& args) {
+	stopJournal(snapshotFileName);
+	if (!writeSnapshot(std::string{ snapshotFileName }, variablesToSave(args, snapshotFileName))) {
+		logMessage("Unexpected error while trying to write into save file '" + std::string{ snapshotFileName } + "' !");
+		return;
+	}
+	std::error_code error{};
+	std::filesystem::remove(textSaveFileName, error);
+}
+
+void command::savetext(const CommandArgs& args) {
+	stopJournal(textSaveFileName);
+	if (!writeTextSave(std::string{ textSaveFileName }, variablesToSave(args, textSaveFileName))) {
+		logMessage("Unexpected error while trying to write into save file '" + std::string{ textSaveFileName } + "' !");
+		return;
+	}
+	std::error_code error{};
+	std::filesystem::remove(snapshotFileName, error);
+}
+
+void command::list([[maybe_unused]] const CommandArgs& args) {
+	for (const auto slot : variables.sortedSlots()) {
+		if (isReservedIdentifier(variables.name(slot))) {
+			output() << "[Reserved] ";
+		}
+		output() << variables.name(slot) << " = ";
+		writeNumber(output(), variables.value(slot));
+		if (const auto formula{ dependencyGraph.formula(slot) }) {
+			output() << " (bound to " << *formula << ')';
+		}
+		output() << '\n';
+	}
+	for (const auto id : functions.sortedIds()) {
+		output() << "[Function] " << functions.function(id).definition << '\n';
+	}
+	output() << '\n';
+}
+
+void command::savelist([[maybe_unused]] const CommandArgs& args) {
+	const auto saveFile{ existingSaveFile() };
+
+	const auto listVariable = [](std::string_view name, Number value) {
+		if (isReservedIdentifier(name)) {
+			output() << "[Reserved] ";
+		}
+		output() << name << " = ";
+		writeNumber(output(), value);
+		output() << '\n';
+	};
+
+	if (!saveFile.has_value() || !readSavedVariables(saveFile.value(), listVariable)) {
+		logMessage("Unexpected error while trying to read save file '" + saveFile.value_or(std::string{ snapshotFileName }) + "' !");
+	}
+}
+
+void command::journal(const CommandArgs& args) {
+	if (args.size() == 2 && args[1] == "on") {
+		if (!::journal.start()) {
+			logMessage("Unexpected error while trying to write into the journal '" + std::string{ journalFileName } + "' !");
+		}
+		return;
+	}
+	if (args.size() == 2) { // "journal off"
+		if (!::journal.stop()) {
+			logMessage("Unexpected error while trying to merge the journal '" + std::string{ journalFileName } + "' !");
+		}
+		return;
+	}
+
+	const auto status{ ::journal.status() };
+	if (!status.isActive) {
+		output() << "Journal : off" << '\n';
+		output() << '\n';
+		return;
+	}
+	output() << "Journal : on, " << status.size << " bytes in '" << journalFileName << "'" << '\n';
+	output() << "Compactions : " << status.compactions << (status.isCompacting ? " (1 running)" : "") << '\n';
+	output() << '\n';
+}
+
+void command::cache(const CommandArgs& args) {
+	if (args.size() == 2) {
+		ExpressionCache::setCapacity(parseCacheCapacity(args[1]).value());
+		return;
+	}
+
+	const auto& statistics{ expressionCache.statistics() };
+	output() << "Cached formulas : " << expressionCache.size() << " / " << ExpressionCache::capacity() << '\n';
+	output() << "Hits : " << statistics.hits << '\n';
+	output() << "Misses : " << statistics.misses << '\n';
+	output() << "Evictions : " << statistics.evictions << '\n';
+	output() << '\n';
+}
+
+void command::nesting(const CommandArgs& args) {
+	if (args.size() == 2) {
+		setMaxNestingDepth(parseNestingLimit(args[1]).value());
+		return;
+	}
+
+	output() << "Nesting limit : " << maxNestingDepth() << '\n';
+	output() << '\n';
+}
+
+void command::stats(const CommandArgs& args) {
+	if constexpr (!arePipelineStatisticsEnabled) {
+		output() << "Pipeline statistics are disabled in this build" << '\n';
+		return;
+	}
+
+	if (args.size() == 2) { // "stats reset"
+		resetPipelineStatistics();
+		return;
+	}
+
+	const auto statistics{ pipelineStatistics() };
+	for (std::size_t i{}; i < nStages; i++) {
+		output() << stageNames[i] << " : " << statistics[i].calls << " calls, " << statistics[i].nanoseconds << " ns, "
+			<< statistics[i].allocatedBytes << " bytes allocated" << '\n';
+	}
+	output() << "deduplicated nodes : " << deduplicatedNodes() << '\n';
+	output() << '\n';
+}
+
+void executeCommand(const CommandArgs& args) {
+	using CommandFunction = void(*)(const CommandArgs&);
+	static constexpr std::array<CommandFunction, commands.size()> commandFunctions{
+		command::set,
+		command::bind,
+		command::def,
+		command::sweep,
+		command::reset,
+		command::save,
+		command::savetext,
+		command::load,
+		command::list,
+		command::savelist,
+		command::journal,
+		command::cache,
+		command::nesting,
+		command::stats
+	}; // same order as 'commands'
+
+	commandFunctions[findCommand(args[0]).value()](args);
+
+	// the variables it modified are saved once the command is complete, with a single write
+	if (!journal.recordModifications()) {
+		logMessage("Unexpected error while trying to write into the journal '" + std::string{ journalFileName } + "', which is stopped !");
+	}
 }
\ No newline at end of file
@@ -1,60 +1,109 @@
-#pragma once
-#include <array>
-#include <string>
-#include <map>
-#include <vector>
-#include <optional>
-#include <variant>
-
-void help();
-
-enum class Error; // defined in ErrorLogging.hpp
-using SyntaxErrorIndexes = std::vector<std::size_t>;
-
-extern std::map<std::string, long double> variables;
-
-using SyntaxErrorDetails = std::pair<Error, SyntaxErrorIndexes>;
-
-constexpr std::array<std::string_view, 6> commands{
-	"set",
-	"reset",
-	"save",
-	"load",
-	"list",
-	"savelist"
-};
-
-constexpr std::array<std::string_view, 2> reservedIdentifiers{
-	"e",
-	"pi"
-};
-
-bool isCommand(const std::string& formula);
-
-// assumes command is correct
-bool hasCommandTheRightNumberOfArgs(const std::string& formula);
-
-bool isReservedIdentifier(const std::string& identifier);
-
-bool isValidVariableName(const std::string& identifier);
-
-using CommandArgs = std::vector<std::string>;
-
-// assumes formula is a well-formed command
-CommandArgs getArgs(const std::string& formula);
-
-// assumes the command has the right number of arguments
-std::optional<SyntaxErrorDetails> checkArguments(const std::string& formula);
-
-// assuming arguments are all OK
-namespace command {
-	// but value wasn't checked before
-	void set(const CommandArgs& args);
-	void reset(const CommandArgs& args);
-	void load(const CommandArgs& args);
-	void save(const CommandArgs& args);
-	void list([[maybe_unused]] const CommandArgs& args);
-	void savelist([[maybe_unused]] const CommandArgs& args);
-}
-
-void executeCommand(const std::string& formula);
\ No newline at end of file
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <variant>
+
+#include "Number.hpp"
+
+// displays the manual, waiting for a key press after each line if 'paginate', otherwise it is written at once into output()
+void help(bool paginate = true);
+
+enum class Error; // defined in ErrorLogging.hpp
+using SyntaxErrorIndexes = std::vector<std::size_t>;
+
+using SyntaxErrorDetails = std::pair<Error, SyntaxErrorIndexes>;
+
+constexpr std::array<std::string_view, 14> commands{
+	"set",
+	"bind",
+	"def",
+	"sweep",
+	"reset",
+	"save",
+	"savetext",
+	"load",
+	"list",
+	"savelist",
+	"journal",
+	"cache",
+	"nesting",
+	"stats"
+};
+
+constexpr std::array<std::string_view, 2> reservedIdentifiers{
+	"e",
+	"pi"
+};
+
+// index of name in 'commands', found with a perfect hash computed at compile time
+std::optional<std::size_t> findCommand(std::string_view name) noexcept;
+
+// true if the first word of formula is a command
+bool isCommand(std::string_view formula);
+
+// arguments of a command line, the first one being the command : views on the line, which must outlive them
+using CommandArgs = std::vector<std::string_view>;
+
+// splits a command line into its arguments, which is done once per line : they are then checked and executed as is
+// the last argument of 'set', 'bind' and 'sweep' is a formula, kept whole with its spaces
+// 'def <name>(<parameters>) = <formula>' has two arguments, the signature before '=' and the formula after it
+// args is cleared first, so that it can be reused, returns false if formula isn't a command
+bool parseCommand(std::string_view formula, CommandArgs& args);
+
+// assumes command is correct
+bool hasCommandTheRightNumberOfArgs(const CommandArgs& args);
+
+bool isReservedIdentifier(std::string_view identifier);
+
+// a variable can't have the name of a function, and conversely
+bool isValidVariableName(std::string_view identifier);
+bool isValidFunctionName(std::string_view identifier);
+
+struct FunctionSignature {
+	std::string_view name{};
+	std::vector<std::string_view> parameters{};
+};
+
+// returns std::nullopt if signature isn't "<name>(<parameters>)", with a valid function name and at least one parameter,
+// parameters being separated by ',' and having distinct names which aren't the ones of functions
+std::optional<FunctionSignature> parseFunctionSignature(std::string_view signature);
+
+// returns std::nullopt if arg isn't a non-negative integer
+std::optional<std::size_t> parseCacheCapacity(std::string_view arg);
+
+// returns std::nullopt if arg isn't a positive integer
+std::optional<std::size_t> parseNestingLimit(std::string_view arg);
+
+// returns std::nullopt if arg isn't a finite number
+std::optional<Number> parseSweepBound(std::string_view arg);
+
+// number of values from 'from' to 'to' (included) by 'step', std::nullopt if step doesn't go from 'from' to 'to'
+std::optional<std::size_t> sweepValuesCount(Number from, Number to, Number step);
+
+// error indexes are the ones of the arguments
+std::optional<SyntaxErrorDetails> checkArguments(const CommandArgs& args);
+
+// assuming arguments are all OK
+namespace command {
+	// but value wasn't checked before
+	void set(const CommandArgs& args);
+	void bind(const CommandArgs& args);
+	void def(const CommandArgs& args);
+	void sweep(const CommandArgs& args);
+	void reset(const CommandArgs& args);
+	void load(const CommandArgs& args);
+	void save(const CommandArgs& args);
+	void savetext(const CommandArgs& args);
+	void list([[maybe_unused]] const CommandArgs& args);
+	void savelist([[maybe_unused]] const CommandArgs& args);
+	void journal(const CommandArgs& args);
+	void cache(const CommandArgs& args);
+	void nesting(const CommandArgs& args);
+	void stats(const CommandArgs& args);
+}
+
+// assumes the arguments were checked
+void executeCommand(const CommandArgs& args);
\ No newline at end of file
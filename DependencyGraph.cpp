@@ -0,0 +1,145 @@
+#include "DependencyGraph.hpp"
+#include "ErrorsLogging.hpp"
+#include <algorithm>
+
+DependencyGraph dependencyGraph{};
+
+void DependencyGraph::bind(SymbolTable::Slot variable, std::string formula, Expression expression) {
+	unbind(variable);
+
+	std::vector<SymbolTable::Slot> dependencies{};
+	for (const auto& node : expression.nodes) {
+		if (node.type == NodeType::Variable) {
+			dependencies.push_back(node.variable);
+		}
+	}
+	std::sort(dependencies.begin(), dependencies.end());
+	dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+	reserve(variable);
+	for (const auto dependency : dependencies) {
+		reserve(dependency);
+		dependents[dependency].push_back(variable);
+	}
+	bindings[variable] = Binding{ std::move(formula), std::move(expression), std::move(dependencies) };
+}
+
+void DependencyGraph::unbind(SymbolTable::Slot variable) {
+	if (variable >= bindings.size() || !bindings[variable].has_value()) {
+		return;
+	}
+
+	for (const auto dependency : bindings[variable]->dependencies) {
+		std::erase(dependents[dependency], variable);
+	}
+	bindings[variable].reset();
+}
+
+void DependencyGraph::remove(SymbolTable::Slot variable) {
+	unbind(variable);
+	if (variable >= dependents.size()) {
+		return;
+	}
+
+	// unbinding a dependent erases it from dependents[variable], so they are taken out first
+	const auto removedDependents{ std::move(dependents[variable]) };
+	dependents[variable].clear();
+	for (const auto dependent : removedDependents) {
+		unbind(dependent);
+	}
+}
+
+void DependencyGraph::clear() {
+	bindings.clear();
+	dependents.clear();
+}
+
+const std::string* DependencyGraph::formula(SymbolTable::Slot variable) const noexcept {
+	if (variable >= bindings.size() || !bindings[variable].has_value()) {
+		return nullptr;
+	}
+	return &bindings[variable]->formula;
+}
+
+bool DependencyGraph::createsCycle(SymbolTable::Slot variable, std::span<const SymbolTable::Slot> dependencies) {
+	reserve(variable);
+	collectDependents(variable);
+	return std::any_of(dependencies.begin(), dependencies.end(), [this](SymbolTable::Slot dependency) {
+		return dependency < marks.size() && marks[dependency] == currentMark;
+	});
+}
+
+void DependencyGraph::propagate(SymbolTable::Slot variable) {
+	if (variable >= dependents.size() || dependents[variable].empty()) {
+		return;
+	}
+
+	// Kahn's algorithm, restricted to the reached variables : a variable is recomputed once all its reached dependencies are
+	for (const auto dependent : collectDependents(variable)) {
+		if (dependent != variable) {
+			const auto& dependencies{ bindings[dependent]->dependencies };
+			pendingDependencies[dependent] = static_cast<std::uint32_t>(std::count_if(dependencies.cbegin(), dependencies.cend(), [this](SymbolTable::Slot dependency) {
+				return marks[dependency] == currentMark;
+			}));
+		}
+	}
+
+	stack.assign(1, variable);
+	while (!stack.empty()) {
+		const auto current{ stack.back() };
+		stack.pop_back();
+
+		if (current != variable) {
+			const auto value{ evaluate(bindings[current]->expression) };
+			if (const auto exactValue{ std::get_if<Value>(&value) }) {
+				variables.set(current, *exactValue);
+			}
+			else {
+				logError(std::get<Error>(value), {}, bindings[current]->formula);
+				logMessage("Failed to recompute variable \"" + std::string{ variables.name(current) } + "\", it keeps its previous value.");
+			}
+		}
+
+		for (const auto dependent : dependents[current]) {
+			if (--pendingDependencies[dependent] == 0) {
+				stack.push_back(dependent);
+			}
+		}
+	}
+}
+
+void DependencyGraph::reserve(SymbolTable::Slot variable) {
+	if (variable < bindings.size()) {
+		return;
+	}
+
+	const auto size{ std::max<std::size_t>(variable + 1, variables.slotCount()) };
+	bindings.resize(size);
+	dependents.resize(size);
+	marks.resize(size);
+	pendingDependencies.resize(size);
+}
+
+const std::vector<SymbolTable::Slot>& DependencyGraph::collectDependents(SymbolTable::Slot variable) {
+	if (++currentMark == 0) { // marks wrapped around, old ones could be mistaken for current ones
+		std::fill(marks.begin(), marks.end(), 0);
+		currentMark = 1;
+	}
+
+	reached.clear();
+	stack.assign(1, variable);
+	marks[variable] = currentMark;
+	while (!stack.empty()) {
+		const auto current{ stack.back() };
+		stack.pop_back();
+		reached.push_back(current);
+
+		for (const auto dependent : dependents[current]) {
+			if (marks[dependent] != currentMark) {
+				marks[dependent] = currentMark;
+				stack.push_back(dependent);
+			}
+		}
+	}
+	return reached;
+}
\ No newline at end of file
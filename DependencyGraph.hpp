@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Expression.hpp"
+#include "SymbolTable.hpp"
+
+// variables bound to a formula, which are recomputed whenever a variable they depend on changes
+// edges go from a variable to the bound variables using it, and never form a cycle
+class DependencyGraph {
+public:
+	// binds variable to formula, replacing its previous formula if any
+	// assumes it doesn't create a cycle
+	void bind(SymbolTable::Slot variable, std::string formula, Expression expression);
+
+	// variable keeps its current value, but isn't recomputed anymore
+	void unbind(SymbolTable::Slot variable);
+
+	// variable is removed : it is unbound, and so are the variables bound to a formula using it, which keep their current value
+	// so that they are never recomputed from the value it had
+	void remove(SymbolTable::Slot variable);
+
+	// removes all the bindings
+	void clear();
+
+	// nullptr if variable isn't bound
+	const std::string* formula(SymbolTable::Slot variable) const noexcept;
+
+	// true if binding variable to a formula using 'dependencies' would make it depend on itself
+	bool createsCycle(SymbolTable::Slot variable, std::span<const SymbolTable::Slot> dependencies);
+
+	// recomputes, in topological order, only the bound variables depending directly or indirectly on variable
+	// a bound variable which fails to be evaluated keeps its previous value
+	void propagate(SymbolTable::Slot variable);
+
+private:
+	struct Binding {
+		std::string formula{};
+		Expression expression{};
+		std::vector<SymbolTable::Slot> dependencies{}; // without duplicates
+	};
+
+	void reserve(SymbolTable::Slot variable);
+
+	// marks the variables reachable from variable, itself included, and returns them in depth-first order
+	const std::vector<SymbolTable::Slot>& collectDependents(SymbolTable::Slot variable);
+
+	std::vector<std::optional<Binding>> bindings{};
+	std::vector<std::vector<SymbolTable::Slot>> dependents{};
+
+	// temporaries of the traversals, kept to avoid allocations
+	// a variable is marked when its mark is the current traversal's one, so marks never need to be cleared
+	std::vector<std::uint32_t> marks{};
+	std::uint32_t currentMark{};
+	std::vector<std::uint32_t> pendingDependencies{}; // for each reached variable, the number of its dependencies not recomputed yet
+	std::vector<SymbolTable::Slot> reached{};
+	std::vector<SymbolTable::Slot> stack{};
+};
+
+extern DependencyGraph dependencyGraph;
\ No newline at end of file
@@ -1,115 +1,317 @@
-#include "ErrorsLogging.hpp"
-#include "Commands.hpp"
-#include <iostream>
-#include <sstream>
-
-void highlightErrorIndexes(SyntaxErrorIndexes indexes, const std::string& formula) {
-	std::clog << formula << std::endl;
-
-	std::size_t i{};
-	for (const auto pos : indexes) {
-		while (i++ != pos) {
-			std::clog << '~';
-		}
-
-		std::clog << '^';
-	}
-	while (i++ != formula.size()) {
-		std::clog << '~';
-	}
-	std::clog << std::endl;
-}
-
-void logError(Error error, SyntaxErrorIndexes indexes, const std::string& formula) {
-	const auto writeErrorMessage = [indexes](const std::string& text, const std::string& pluralSuffix = "s", const std::string& messageEnd = "") {
-		std::cerr << text;
-		if (indexes.size() > 1) {
-			std::cerr << pluralSuffix;
-		}
-		std::cerr << messageEnd << " !" << std::endl;
-	};
-
-	const auto unexpectedArgumentDetails = [indexes]() {
-		std::ostringstream sstream{};
-		for (std::size_t i{}; i < indexes.size(); i++) {
-			sstream << indexes[i];
-			if (i < indexes.size() - 1) {
-				sstream << ", ";
-			}
-		}
-		return sstream.str();
-	};
-
-	const auto argIndexToFormulaIndex = [formula](std::size_t argIndex) {
-		return 1 + formula.substr(1).find(getArgs(formula)[argIndex]);
-		// begins the search at index 1, so that there isn't confusion => e.g : "set set 50" -> avoid returning '0'
-	};
-
-	switch (error) {
-	case Error::AloneOperators:
-		writeErrorMessage("Unexpected operator");
-		break;
-
-	case Error::CommasOutsideNumber:
-		writeErrorMessage("Comma", "s", "outside a number");
-		break;
-
-	case Error::EmptyDelimiters:
-		if (indexes.size() == 1) {
-			writeErrorMessage("Empty parenthesis or square bracket");
-		}
-		else {
-			writeErrorMessage("Empty parenthesises and/or square brackets", "");
-		}
-		break;
-
-	case Error::MultipleCommas:
-		writeErrorMessage("Multiple commas in the same number", "");
-		break;
-
-	case Error::MultipleOperators:
-		writeErrorMessage("Multiple operators side-by-side", "");
-		break;
-
-	case Error::UnmatchedDelimiters:
-		if (indexes.size() == 1) {
-			writeErrorMessage("Unmatched parenthesis or square bracket");
-		}
-		else {
-			writeErrorMessage("Unmatched parenthesis and/or square brackets", "");
-		}
-		break;
-
-	case Error::UnrecognizedCharacters:
-		writeErrorMessage("Unrecognized character");
-		break;
-
-	case Error::BadVariableName:
-		writeErrorMessage("Incorrect variable name : " + getArgs(formula)[1]);
-		indexes[0] = argIndexToFormulaIndex(indexes[0]);
-		break;
-
-	case Error::MissingVariableName:
-		writeErrorMessage("Missing variable name");
-		break;
-
-	case Error::UnexpectedArgument:
-		writeErrorMessage("Unexpected argument", "s", unexpectedArgumentDetails());
-		break;
-
-	case Error::NoSaveFile:
-		writeErrorMessage("No save file found ('vars.txt'), cannot load variables");
-		break;
-
-	case Error::UnknownIndentifier:
-		writeErrorMessage("Unknown identifier");
-		for (auto& i : indexes) {
-			i = argIndexToFormulaIndex(i);
-		}
-		break;
-
-	case Error::Max:
-		break;
-	}
-	highlightErrorIndexes(indexes, formula);
+#include "ErrorsLogging.hpp"
+#include "Output.hpp"
+#include "SyntaxChecking.hpp"
+#include <array>
+#include <functional>
+#include <sstream>
+
+static DiagnosticsFormat diagnosticsFormat{ DiagnosticsFormat::Text };
+static thread_local std::size_t diagnosticsLine{};
+static thread_local std::string_view diagnosticsInput{};
+
+constexpr std::array<std::string_view, nErrors> errorCodes{
+	"UnrecognizedCharacters",
+	"UnknownIndentifier",
+	"UnmatchedDelimiters",
+	"NestingTooDeep",
+	"BadFunctionCall",
+	"MultipleOperators",
+	"EmptyDelimiters",
+	"AloneOperators",
+	"CommasOutsideNumber",
+	"MultipleCommas",
+	"BadVariableName",
+	"BadFunctionDefinition",
+	"MissingVariableName",
+	"NoSaveFile",
+	"UnexpectedArgument",
+	"BadCacheCapacity",
+	"BadNestingLimit",
+	"MissingFormula",
+	"CyclicDependency",
+	"MissingSweepArguments",
+	"BadSweepRange",
+	"DivisionByZero",
+	"ModuloOfNonIntegers",
+	"ModuloByZero"
+}; // same order as Error
+
+void setDiagnosticsFormat(DiagnosticsFormat format) noexcept {
+	diagnosticsFormat = format;
+}
+
+std::optional<DiagnosticsFormat> parseDiagnosticsFormat(std::string_view name) noexcept {
+	if (name == "text") {
+		return DiagnosticsFormat::Text;
+	}
+	if (name == "json") {
+		return DiagnosticsFormat::Json;
+	}
+	return std::nullopt;
+}
+
+void setDiagnosticsLine(std::size_t line) noexcept {
+	diagnosticsLine = line;
+}
+
+void setDiagnosticsInput(std::string_view input) noexcept {
+	diagnosticsInput = input;
+}
+
+// offset of part in diagnosticsInput, 0 if it isn't a part of it
+static std::size_t offsetInDiagnosticsInput(std::string_view part) noexcept {
+	const std::less_equal<const char*> isBeforeOrAt{};
+	if (isBeforeOrAt(diagnosticsInput.data(), part.data()) && isBeforeOrAt(part.data() + part.size(), diagnosticsInput.data() + diagnosticsInput.size())) {
+		return static_cast<std::size_t>(part.data() - diagnosticsInput.data());
+	}
+	return 0;
+}
+
+// formula, then a line with a '^' under each error index and '~' elsewhere
+static void highlightErrorIndexes(const SyntaxErrorIndexes& indexes, std::string_view formula, std::string& text) {
+	text += formula;
+	text += '\n';
+
+	std::size_t i{};
+	for (const auto pos : indexes) {
+		while (i++ != pos) {
+			text += '~';
+		}
+
+		text += '^';
+	}
+	while (i++ != formula.size()) {
+		text += '~';
+	}
+	text += '\n';
+}
+
+static void appendJsonString(std::string& json, std::string_view text) {
+	json += '"';
+	for (const char c : text) {
+		switch (c) {
+		case '"':
+			json += "\\\"";
+			break;
+		case '\\':
+			json += "\\\\";
+			break;
+		case '\n':
+			json += "\\n";
+			break;
+		case '\t':
+			json += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				constexpr std::string_view hexDigits{ "0123456789abcdef" };
+				json += "\\u00";
+				json += hexDigits[static_cast<unsigned char>(c) >> 4];
+				json += hexDigits[static_cast<unsigned char>(c) & 0xF];
+			}
+			else {
+				json += c;
+			}
+		}
+	}
+	json += '"';
+}
+
+void logDiagnostic(const Diagnostic& diagnostic, std::string_view input) {
+	thread_local std::string text{}; // reused, so that only the first diagnostics allocate
+	text.clear();
+
+	if (diagnosticsFormat == DiagnosticsFormat::Json) {
+		text += "{ \"line\": ";
+		text += std::to_string(diagnosticsLine);
+		text += ", \"code\": ";
+		if (diagnostic.error.has_value()) {
+			appendJsonString(text, errorCodes[static_cast<std::size_t>(diagnostic.error.value())]);
+		}
+		else {
+			text += "null";
+		}
+		text += ", \"offsets\": [";
+		const auto inputOffset{ offsetInDiagnosticsInput(input) };
+		for (std::size_t i{}; i < diagnostic.offsets.size(); i++) {
+			text += i == 0 ? "" : ", ";
+			text += std::to_string(inputOffset + diagnostic.offsets[i]);
+		}
+		text += "], \"message\": ";
+		appendJsonString(text, diagnostic.message);
+		text += " }\n";
+	}
+	else {
+		text += diagnostic.message;
+		if (diagnostic.error.has_value()) {
+			text += " !";
+		}
+		text += '\n';
+		if (diagnostic.error.has_value() && !isEvaluationError(diagnostic.error.value())) {
+			highlightErrorIndexes(diagnostic.offsets, input, text);
+		}
+	}
+
+	errorOutput().write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+void logMessage(std::string message) {
+	logDiagnostic({ .message = std::move(message) });
+}
+
+void logError(Error error, SyntaxErrorIndexes indexes, std::string_view formula, std::span<const std::string_view> args) {
+	std::string message{};
+	const auto writeErrorMessage = [&message, &indexes](const std::string& text, const std::string& pluralSuffix = "s", const std::string& messageEnd = "") {
+		message = text;
+		if (indexes.size() > 1) {
+			message += pluralSuffix;
+		}
+		message += messageEnd;
+	};
+
+	const auto unexpectedArgumentDetails = [&indexes]() {
+		std::ostringstream sstream{};
+		for (std::size_t i{}; i < indexes.size(); i++) {
+			sstream << indexes[i];
+			if (i < indexes.size() - 1) {
+				sstream << ", ";
+			}
+		}
+		return sstream.str();
+	};
+
+	const auto argIndexToFormulaIndex = [formula, args](std::size_t argIndex) {
+		if (args.empty()) { // not a command, e.g. unknown identifiers of a formula are already indexes in it
+			return argIndex;
+		}
+		return static_cast<std::size_t>(args[argIndex].data() - formula.data());
+	};
+
+	switch (error) {
+	case Error::AloneOperators:
+		writeErrorMessage("Unexpected operator");
+		break;
+
+	case Error::CommasOutsideNumber:
+		writeErrorMessage("Comma", "s", "outside a number");
+		break;
+
+	case Error::EmptyDelimiters:
+		if (indexes.size() == 1) {
+			writeErrorMessage("Empty parenthesis or square bracket");
+		}
+		else {
+			writeErrorMessage("Empty parenthesises and/or square brackets", "");
+		}
+		break;
+
+	case Error::MultipleCommas:
+		writeErrorMessage("Multiple commas in the same number", "");
+		break;
+
+	case Error::MultipleOperators:
+		writeErrorMessage("Multiple operators side-by-side", "");
+		break;
+
+	case Error::UnmatchedDelimiters:
+		if (indexes.size() == 1) {
+			writeErrorMessage("Unmatched parenthesis or square bracket");
+		}
+		else {
+			writeErrorMessage("Unmatched parenthesis and/or square brackets", "");
+		}
+		break;
+
+	case Error::NestingTooDeep:
+		writeErrorMessage("Parenthesises and square brackets nested deeper than the limit of " + std::to_string(maxNestingDepth()) + " (see 'nesting')", "");
+		break;
+
+	case Error::BadFunctionCall:
+		writeErrorMessage("Incorrect function call, expected its name then its arguments between delimiters, separated by ','", "");
+		break;
+
+	case Error::UnrecognizedCharacters:
+		writeErrorMessage("Unrecognized character");
+		break;
+
+	case Error::BadVariableName:
+		writeErrorMessage("Incorrect variable name : " + std::string{ args[1] });
+		indexes[0] = argIndexToFormulaIndex(indexes[0]);
+		break;
+
+	case Error::BadFunctionDefinition:
+		writeErrorMessage("Incorrect function definition, expected 'def <name>(<parameters>) = <formula>'", "");
+		if (!indexes.empty()) {
+			indexes[0] = argIndexToFormulaIndex(indexes[0]);
+		}
+		break;
+
+	case Error::BadCacheCapacity:
+		writeErrorMessage("Incorrect cache capacity : " + std::string{ args[1] });
+		indexes[0] = argIndexToFormulaIndex(indexes[0]);
+		break;
+
+	case Error::BadNestingLimit:
+		writeErrorMessage("Incorrect nesting limit : " + std::string{ args[1] });
+		indexes[0] = argIndexToFormulaIndex(indexes[0]);
+		break;
+
+	case Error::CyclicDependency:
+		writeErrorMessage("Cyclic dependency, \"" + std::string{ args[1] } + "\" would depend on itself", "");
+		indexes[0] = argIndexToFormulaIndex(indexes[0]);
+		break;
+
+	case Error::MissingSweepArguments:
+		writeErrorMessage("Missing arguments, expected 'sweep <name> <from> <to> <step> <formula>'", "");
+		break;
+
+	case Error::BadSweepRange:
+		writeErrorMessage("Incorrect sweep range");
+		for (auto& i : indexes) {
+			i = argIndexToFormulaIndex(i);
+		}
+		break;
+
+	case Error::MissingFormula:
+		writeErrorMessage("Missing formula");
+		break;
+
+	case Error::MissingVariableName:
+		writeErrorMessage("Missing variable name");
+		break;
+
+	case Error::UnexpectedArgument:
+		writeErrorMessage("Unexpected argument", "s", unexpectedArgumentDetails());
+		for (auto& i : indexes) { // the message tells the arguments' numbers, the offsets are their positions in the line
+			i = argIndexToFormulaIndex(i);
+		}
+		break;
+
+	case Error::NoSaveFile:
+		writeErrorMessage("No save file found ('vars.bin' or 'vars.txt'), cannot load variables");
+		break;
+
+	case Error::UnknownIndentifier:
+		writeErrorMessage("Unknown identifier");
+		for (auto& i : indexes) {
+			i = argIndexToFormulaIndex(i);
+		}
+		break;
+
+	case Error::DivisionByZero:
+		writeErrorMessage("A division by zero occured", "");
+		break;
+
+	case Error::ModuloOfNonIntegers:
+		writeErrorMessage("A modulo with non-integer values occured", "");
+		break;
+
+	case Error::ModuloByZero:
+		writeErrorMessage("A modulo with a zero right-operand occured", "");
+		break;
+
+	case Error::Max:
+		break;
+	}
+	logDiagnostic({ .error = error, .offsets = std::move(indexes), .message = std::move(message) }, formula);
 }
\ No newline at end of file
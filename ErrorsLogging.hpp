@@ -1,31 +1,84 @@
-#pragma once
-#include <vector>
-#include <string>
-
-using SyntaxErrorIndexes = std::vector<std::size_t>;
-
-void highlightErrorIndexes(SyntaxErrorIndexes indexes, const std::string& formula);
-
-enum class Error {
-
-	// Expression parsing
-	UnrecognizedCharacters,
-	UnknownIndentifier,
-	UnmatchedDelimiters,
-	MultipleOperators,
-	EmptyDelimiters,
-	AloneOperators,
-	CommasOutsideNumber,
-	MultipleCommas,
-
-	BadVariableName,
-	MissingVariableName,
-	NoSaveFile,
-	UnexpectedArgument,
-
-	Max
-};
-
-constexpr std::size_t nErrors{ static_cast<std::size_t>(Error::Max) };
-
-void logError(Error error, SyntaxErrorIndexes indexes, const std::string& formula);
\ No newline at end of file
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+#include <string>
+#include <string_view>
+
+using SyntaxErrorIndexes = std::vector<std::size_t>;
+
+enum class Error {
+
+	// Expression parsing
+	UnrecognizedCharacters,
+	UnknownIndentifier,
+	UnmatchedDelimiters,
+	NestingTooDeep,
+	BadFunctionCall,
+	MultipleOperators,
+	EmptyDelimiters,
+	AloneOperators,
+	CommasOutsideNumber,
+	MultipleCommas,
+
+	BadVariableName,
+	BadFunctionDefinition,
+	MissingVariableName,
+	NoSaveFile,
+	UnexpectedArgument,
+	BadCacheCapacity,
+	BadNestingLimit,
+	MissingFormula,
+	CyclicDependency,
+	MissingSweepArguments,
+	BadSweepRange,
+
+	// Expression evaluation, returned by the evaluation functions rather than written by them
+	DivisionByZero,
+	ModuloOfNonIntegers,
+	ModuloByZero,
+
+	Max
+};
+
+constexpr std::size_t nErrors{ static_cast<std::size_t>(Error::Max) };
+
+constexpr bool isEvaluationError(Error error) noexcept {
+	return error >= Error::DivisionByZero && error < Error::Max;
+}
+
+enum class DiagnosticsFormat {
+	Text,	// the message, then the input with a '^' under each error offset
+	Json	// a JSON object per line : { "line": 3, "code": "DivisionByZero", "offsets": [], "message": "..." }
+};
+
+// set once, before any input is processed, by '--diagnostics=<text|json>'
+void setDiagnosticsFormat(DiagnosticsFormat format) noexcept;
+
+// std::nullopt if name is neither "text" nor "json"
+std::optional<DiagnosticsFormat> parseDiagnosticsFormat(std::string_view name) noexcept;
+
+// line of the input being processed by the current thread (1 for the first one), written into its diagnostics
+void setDiagnosticsLine(std::size_t line) noexcept;
+
+// input being processed by the current thread, which must outlive its diagnostics
+// offsets in a part of it, such as the formula of a 'set', are written relative to the whole input in the JSON format
+void setDiagnosticsInput(std::string_view input) noexcept;
+
+// an error, or a note about an input (such as a warning) when there is no error code
+struct Diagnostic {
+	std::optional<Error> error{};
+	SyntaxErrorIndexes offsets{}; // in bytes from the beginning of the highlighted input
+	std::string message{}; // without the " !" ending errors in the text format
+};
+
+// formats diagnostic into a buffer, written at once into errorOutput(), so that a bad input costs a single write
+// input is only used to highlight the offsets in the text format
+void logDiagnostic(const Diagnostic& diagnostic, std::string_view input = {});
+
+// for errors of a command, args are its arguments (views on formula) and indexes are the ones of the arguments
+// evaluation errors have no indexes
+void logError(Error error, SyntaxErrorIndexes indexes, std::string_view formula, std::span<const std::string_view> args = {});
+
+// diagnostic without error code nor offsets
+void logMessage(std::string message);
\ No newline at end of file
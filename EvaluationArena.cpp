@@ -0,0 +1,71 @@
+#include "EvaluationArena.hpp"
+#include <algorithm>
+
+thread_local EvaluationArena evaluationArena{};
+
+EvaluationArena::EvaluationArena() :
+	buffer(initialSize)
+{
+	arena.emplace(buffer.data(), buffer.size(), &overflow);
+}
+
+std::pmr::memory_resource* EvaluationArena::resource() noexcept {
+#ifdef CALCULATOR_NO_STATISTICS
+	return &arena.value();
+#else
+	return &counting;
+#endif
+}
+
+std::size_t EvaluationArena::allocatedBytes() const noexcept {
+#ifdef CALCULATOR_NO_STATISTICS
+	return 0;
+#else
+	return counting.allocatedBytes;
+#endif
+}
+
+void EvaluationArena::reset() {
+	arena->release();
+
+	if (overflow.allocatedBytes > 0 && buffer.size() < maxRetainedSize) { // the last input didn't fit
+		buffer = std::vector<std::byte>(std::min(2 * (buffer.size() + overflow.allocatedBytes), maxRetainedSize));
+		arena.emplace(buffer.data(), buffer.size(), &overflow);
+	}
+	overflow.allocatedBytes = 0;
+}
+
+void* EvaluationArena::OverflowResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+	allocatedBytes += bytes;
+	return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void EvaluationArena::OverflowResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+	std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool EvaluationArena::OverflowResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	return this == &other;
+}
+
+#ifndef CALCULATOR_NO_STATISTICS
+
+EvaluationArena::CountingResource::CountingResource(EvaluationArena& owner) noexcept :
+	owner{ owner }
+{
+}
+
+void* EvaluationArena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+	allocatedBytes += bytes;
+	return owner.arena->allocate(bytes, alignment);
+}
+
+void EvaluationArena::CountingResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+	owner.arena->deallocate(pointer, bytes, alignment);
+}
+
+bool EvaluationArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+	return this == &other;
+}
+
+#endif
\ No newline at end of file
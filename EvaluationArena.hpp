@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+// monotonic memory for the temporaries of the inputs processed by a thread, released all at once between inputs
+// the arena keeps its memory and grows to fit the biggest input, so that inputs stop allocating once it is warm
+// it doesn't grow beyond maxRetainedSize : larger inputs, such as formulas nested a million times, allocate what doesn't fit
+// and release it once processed, rather than keeping hundreds of megabytes for the rest of the thread
+class EvaluationArena {
+public:
+	EvaluationArena();
+
+	EvaluationArena(const EvaluationArena&) = delete;
+	EvaluationArena& operator=(const EvaluationArena&) = delete;
+
+	std::pmr::memory_resource* resource() noexcept;
+
+	// bytes allocated through resource() since the thread started, only counted for the pipeline statistics
+	std::size_t allocatedBytes() const noexcept;
+
+	// releases everything allocated since the last reset, which must not be used anymore
+	void reset();
+
+private:
+	// allocates what doesn't fit into 'buffer', and counts it to know how much 'buffer' must grow
+	class OverflowResource : public std::pmr::memory_resource {
+	public:
+		std::size_t allocatedBytes{};
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+	};
+
+#ifndef CALCULATOR_NO_STATISTICS
+	// forwards to the arena, counting what is allocated
+	class CountingResource : public std::pmr::memory_resource {
+	public:
+		explicit CountingResource(EvaluationArena& owner) noexcept;
+
+		std::size_t allocatedBytes{};
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		EvaluationArena& owner;
+	};
+
+	CountingResource counting{ *this };
+#endif
+
+	static constexpr std::size_t initialSize{ 16 * 1024 };
+	static constexpr std::size_t maxRetainedSize{ 64 * 1024 * 1024 };
+
+	std::vector<std::byte> buffer{};
+	OverflowResource overflow{};
+	std::optional<std::pmr::monotonic_buffer_resource> arena{};
+};
+
+extern thread_local EvaluationArena evaluationArena;
\ No newline at end of file
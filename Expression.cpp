@@ -0,0 +1,342 @@
+#include "Expression.hpp"
+#include "EvaluationArena.hpp"
+#include "FunctionTable.hpp"
+#include "PipelineStatistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// operators waiting for their right operand while parsing, with opening delimiters as boundaries
+struct PendingOperator {
+	enum class Kind {
+		Binary,
+		Negate,
+		OpeningDelimiter,
+		Call	// applied once the closing delimiter of its arguments is reached
+	};
+
+	Kind kind{};
+	Operator op{};				// only for Kind::Binary
+	FunctionTable::Id function{};	// only for Kind::Call
+};
+
+// priorities are doubled to fit the unary '-' between '/' and '^' => "-2^2" is "-(2^2)" but "-2/4" is "(-2)/4"
+static std::size_t pendingOperatorPriority(const PendingOperator& pendingOperator) {
+	switch (pendingOperator.kind) {
+	case PendingOperator::Kind::Binary:
+		return 2 * operatorPriority(pendingOperator.op);
+
+	case PendingOperator::Kind::Negate:
+		return 2 * operatorPriority(Operator::Power) - 1;
+
+	default: // an opening delimiter or a call is never applied before the closing delimiter is reached
+		return 0;
+	}
+}
+
+// shunting-yard algorithm, each token is pushed and popped at most once, so it runs in linear time
+// assumes tokens come from a formula whose syntax was checked previously
+Expression parse(std::span<const Token> tokens) {
+	const StageTimer timer{ Stage::Parse };
+	Expression expression{};
+	std::pmr::vector<std::size_t> operands{ evaluationArena.resource() }; // indexes of the nodes not used as operands yet
+	std::pmr::vector<PendingOperator> pendingOperators{ evaluationArena.resource() };
+
+	const auto addNode = [&expression, &operands](const Node& node) {
+		expression.nodes.push_back(node);
+		operands.push_back(expression.nodes.size() - 1);
+	};
+
+	// set if an operator lacks operands, or a delimiter isn't opened, which a formula whose syntax was checked never does
+	bool isMalformed{};
+
+	// builds the node of the last pending operator from the last operands
+	const auto applyPendingOperator = [&] {
+		const auto pendingOperator{ pendingOperators.back() };
+		pendingOperators.pop_back();
+		if (operands.size() < (pendingOperator.kind == PendingOperator::Kind::Negate ? 1u : 2u)) {
+			isMalformed = true;
+			return;
+		}
+
+		const auto rightOperand{ operands.back() };
+		operands.pop_back();
+		if (pendingOperator.kind == PendingOperator::Kind::Negate) {
+			addNode({ .type = NodeType::Negate, .left = rightOperand });
+			return;
+		}
+
+		const auto leftOperand{ operands.back() };
+		operands.pop_back();
+		addNode({ .type = NodeType::Operation, .op = pendingOperator.op, .left = leftOperand, .right = rightOperand });
+	};
+
+	// copies the body of function, whose parameters are replaced by the last operands, which are its arguments
+	// arguments aren't copied, so the body's nodes using the same parameter share its argument
+	std::pmr::vector<std::size_t> bodyIndexes{ evaluationArena.resource() }; // index of each node of the body, once copied
+	const auto inlineCall = [&](const Function& function) {
+		const auto firstArgument{ operands.size() - function.parametersCount };
+		bodyIndexes.resize(function.body.nodes.size());
+
+		for (std::size_t i{}; const auto & bodyNode : function.body.nodes) {
+			if (bodyNode.type == NodeType::Variable && isParameterSlot(bodyNode.variable)) {
+				bodyIndexes[i++] = operands[firstArgument + (bodyNode.variable - firstParameterSlot)];
+				continue;
+			}
+
+			auto node{ bodyNode };
+			if (node.type == NodeType::Negate || node.type == NodeType::Operation) {
+				node.left = bodyIndexes[node.left];
+				node.right = node.type == NodeType::Operation ? bodyIndexes[node.right] : 0;
+			}
+			expression.nodes.push_back(node);
+			bodyIndexes[i++] = expression.nodes.size() - 1;
+		}
+
+		operands.resize(firstArgument);
+		operands.push_back(bodyIndexes.back());
+	};
+
+	// an operator is a prefix one if it doesn't follow an operand, e.g -> "-3" ; "2*-3"
+	bool expectsOperand{ true };
+
+	for (const auto& token : tokens) {
+		switch (token.type) {
+		case TokenType::Number:
+			addNode({ .type = NodeType::Number, .number = token.number });
+			expectsOperand = false;
+			break;
+
+		case TokenType::Variable:
+			addNode({ .type = NodeType::Variable, .variable = token.variable });
+			expectsOperand = false;
+			break;
+
+		case TokenType::Function:
+			pendingOperators.push_back({ .kind = PendingOperator::Kind::Call, .function = token.function });
+			expectsOperand = true;
+			break;
+
+		case TokenType::OpeningDelimiter:
+			pendingOperators.push_back({ .kind = PendingOperator::Kind::OpeningDelimiter });
+			expectsOperand = true;
+			break;
+
+		case TokenType::ArgumentSeparator: // the previous argument is complete
+			while (!pendingOperators.empty() && pendingOperators.back().kind != PendingOperator::Kind::OpeningDelimiter) {
+				applyPendingOperator();
+			}
+			if (pendingOperators.empty()) {
+				return Expression{};
+			}
+			expectsOperand = true;
+			break;
+
+		case TokenType::ClosingDelimiter:
+			while (!pendingOperators.empty() && pendingOperators.back().kind != PendingOperator::Kind::OpeningDelimiter) {
+				applyPendingOperator();
+			}
+			if (pendingOperators.empty()) {
+				return Expression{};
+			}
+			pendingOperators.pop_back();
+			if (!pendingOperators.empty() && pendingOperators.back().kind == PendingOperator::Kind::Call) {
+				inlineCall(functions.function(pendingOperators.back().function));
+				pendingOperators.pop_back();
+			}
+			expectsOperand = false;
+			break;
+
+		case TokenType::Operator: {
+			if (expectsOperand) {
+				// a prefix '+' is useless, e.g -> "2*+3" <=> "2*3"
+				if (token.op == Operator::Minus) {
+					pendingOperators.push_back({ .kind = PendingOperator::Kind::Negate });
+				}
+				break;
+			}
+
+			// the first operator with the highest priority is applied first => "2^3^2" is "(2^3)^2"
+			const PendingOperator binaryOperator{ .kind = PendingOperator::Kind::Binary, .op = token.op };
+			while (!pendingOperators.empty() && pendingOperatorPriority(pendingOperators.back()) >= pendingOperatorPriority(binaryOperator)) {
+				applyPendingOperator();
+			}
+			pendingOperators.push_back(binaryOperator);
+			expectsOperand = true;
+			break;
+		}
+		}
+	}
+
+	while (!pendingOperators.empty()) {
+		applyPendingOperator();
+	}
+	if (isMalformed) {
+		return Expression{}; // evaluated as Error::MissingFormula, rather than reading operands which don't exist
+	}
+
+	// the root must be the last node, which isn't the case if it is an argument returned by a function, e.g -> "f(a, b)" returning a
+	if (!operands.empty() && operands.back() != expression.nodes.size() - 1) {
+		expression.nodes.push_back(expression.nodes[operands.back()]);
+	}
+	return expression;
+}
+
+std::variant<Number, Error> applyOperator(Operator op, Number firstOperand, Number secondOperand) {
+	const auto isInteger = [](Number value) { return number::trunc(value) == value; };
+
+	switch (op) {
+	case Operator::Plus:
+		return firstOperand + secondOperand;
+
+	case Operator::Minus:
+		return firstOperand - secondOperand;
+
+	case Operator::Multiply:
+		return firstOperand * secondOperand;
+
+	case Operator::Divide:
+		if (secondOperand == 0) {
+			return Error::DivisionByZero;
+		}
+		return firstOperand / secondOperand;
+
+	case Operator::Modulo:
+		if (!isInteger(firstOperand) || !isInteger(secondOperand)) {
+			return Error::ModuloOfNonIntegers;
+		}
+		if (secondOperand == 0) {
+			return Error::ModuloByZero;
+		}
+		return number::fmod(firstOperand, secondOperand);
+
+	case Operator::Power:
+		break;
+	}
+	return number::pow(firstOperand, secondOperand);
+}
+
+EvaluationResult evaluate(const Expression& expression) {
+	const StageTimer timer{ Stage::Evaluate };
+	if (expression.nodes.empty()) {
+		return Error::MissingFormula;
+	}
+
+	// value-initialized, so that copying a value never reads a member its operator didn't write
+	// Value is an aggregate whose members are all zero when value-initialized, so the values are zeroed at once rather than
+	// constructed one by one, which costs as much as evaluating simple operators on them
+	Value* const values{ std::pmr::polymorphic_allocator<Value>{ evaluationArena.resource() }.allocate(expression.nodes.size()) };
+	std::memset(static_cast<void*>(values), 0, expression.nodes.size() * sizeof(Value));
+
+	for (std::size_t i{}; const auto & node : expression.nodes) {
+		switch (node.type) {
+		case NodeType::Number:
+			values[i] = node.number;
+			break;
+
+		case NodeType::Variable:
+			values[i] = variables.exactValue(node.variable);
+			break;
+
+		case NodeType::Negate:
+			values[i] = negate(values[node.left]);
+			break;
+
+		case NodeType::Operation:
+			if (const auto error{ applyOperator(node.op, values[node.left], values[node.right], values[i]) }) {
+				return error.value();
+			}
+			break;
+		}
+		i++;
+	}
+
+	return values[expression.nodes.size() - 1];
+}
+
+void evaluateBatch(const Expression& expression, SymbolTable::Slot variable, std::span<const Number> variableValues, std::span<Number> results, std::span<bool> failures) {
+	const StageTimer timer{ Stage::Evaluate };
+	const auto lanes{ variableValues.size() };
+	std::fill(failures.begin(), failures.end(), expression.nodes.empty());
+	if (expression.nodes.empty()) {
+		return;
+	}
+
+	// values of node i are lanesValues[i * batchSize to i * batchSize + lanes - 1]
+	std::pmr::vector<Number> lanesValues(expression.nodes.size() * batchSize, evaluationArena.resource());
+	const auto isInteger = [](Number value) { return number::trunc(value) == value; };
+
+	for (std::size_t i{}; const auto & node : expression.nodes) {
+		Number* const values{ lanesValues.data() + i * batchSize };
+		const Number* const left{ lanesValues.data() + node.left * batchSize };
+		const Number* const right{ lanesValues.data() + node.right * batchSize };
+
+		switch (node.type) {
+		case NodeType::Number:
+			std::fill_n(values, lanes, toNumber(node.number));
+			break;
+
+		case NodeType::Variable:
+			if (node.variable == variable) {
+				std::copy(variableValues.begin(), variableValues.end(), values);
+			}
+			else {
+				std::fill_n(values, lanes, variables.value(node.variable));
+			}
+			break;
+
+		case NodeType::Negate:
+			for (std::size_t lane{}; lane < lanes; lane++) {
+				values[lane] = -left[lane];
+			}
+			break;
+
+		case NodeType::Operation:
+			// the operator is tested once per node rather than once per lane
+			switch (node.op) {
+			case Operator::Plus:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					values[lane] = left[lane] + right[lane];
+				}
+				break;
+
+			case Operator::Minus:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					values[lane] = left[lane] - right[lane];
+				}
+				break;
+
+			case Operator::Multiply:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					values[lane] = left[lane] * right[lane];
+				}
+				break;
+
+			case Operator::Divide:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					failures[lane] = failures[lane] || right[lane] == 0;
+					values[lane] = left[lane] / right[lane];
+				}
+				break;
+
+			case Operator::Modulo:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					failures[lane] = failures[lane] || !isInteger(left[lane]) || !isInteger(right[lane]) || right[lane] == 0;
+					values[lane] = number::fmod(left[lane], right[lane]);
+				}
+				break;
+
+			case Operator::Power:
+				for (std::size_t lane{}; lane < lanes; lane++) {
+					values[lane] = number::pow(left[lane], right[lane]);
+				}
+				break;
+			}
+			break;
+		}
+		i++;
+	}
+
+	const Number* const rootValues{ lanesValues.data() + (expression.nodes.size() - 1) * batchSize };
+	std::copy_n(rootValues, lanes, results.begin());
+}
\ No newline at end of file
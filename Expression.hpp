@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <span>
+#include <variant>
+
+#include "ErrorsLogging.hpp"
+#include "Lexer.hpp"
+
+enum class NodeType {
+	Number,
+	Variable,
+	Negate,		// unary '-', its operand is 'left'
+	Operation	// binary operator, operands are 'left' and 'right'
+};
+
+struct Node {
+	NodeType type{};
+	Operator op{};					// only for NodeType::Operation
+	Value number{};					// only for NodeType::Number
+	SymbolTable::Slot variable{};	// only for NodeType::Variable, slot of the variable in 'variables'
+	std::size_t left{};				// index of the left (or only) operand in Expression::nodes
+	std::size_t right{};			// index of the right operand in Expression::nodes
+};
+
+// nodes are stored in post-order : each node comes after its operands, so the root is the last one
+struct Expression {
+	std::vector<Node> nodes{};
+};
+
+// runs in linear time, temporaries are allocated in evaluationArena
+// function calls are inlined : the body of the function is copied, with its parameters replaced by the nodes of the arguments
+// assumes tokens come from a formula whose syntax was checked previously, otherwise the expression is empty if an operator lacks
+// operands or a delimiter isn't opened
+Expression parse(std::span<const Token> tokens);
+
+// value of a whole expression, still exact if it is an integer, or the evaluation error which prevents computing it
+// nothing is written by the evaluation functions, their callers decide whether and how errors are reported
+using EvaluationResult = std::variant<Value, Error>;
+
+// fails for a division by zero or a modulo with non-integer values or a zero right-operand
+std::variant<Number, Error> applyOperator(Operator op, Number firstOperand, Number secondOperand);
+
+// result of an operator on two integers, std::nullopt if it overflows, if it isn't an integer (e.g "1/3" or "2^-1"),
+// or if it fails (division or modulo by zero) : the operator must then be applied to Numbers
+inline std::optional<std::int64_t> applyIntegerOperator(Operator op, std::int64_t firstOperand, std::int64_t secondOperand) noexcept {
+	switch (op) {
+	case Operator::Plus:
+		return integer::add(firstOperand, secondOperand);
+
+	case Operator::Minus:
+		return integer::subtract(firstOperand, secondOperand);
+
+	case Operator::Multiply:
+		return integer::multiply(firstOperand, secondOperand);
+
+	case Operator::Divide:
+		if (secondOperand == -1) { // -2^63 / -1 overflows
+			return integer::subtract(0, firstOperand);
+		}
+		if (secondOperand == 0 || firstOperand % secondOperand != 0) {
+			return std::nullopt;
+		}
+		return firstOperand / secondOperand;
+
+	case Operator::Modulo:
+		if (secondOperand == 0) {
+			return std::nullopt;
+		}
+		return secondOperand == -1 ? 0 : firstOperand % secondOperand; // -2^63 % -1 overflows
+
+	case Operator::Power:
+		return integer::power(firstOperand, secondOperand);
+	}
+	return std::nullopt;
+}
+
+// integers are computed exactly with applyIntegerOperator, other values and integers for which it fails are computed as Numbers
+// writes into result rather than returning it, as copying a Value costs as much as the operation itself with long doubles
+// only the active member of result is written, result is left unchanged on failure, the error being returned
+inline std::optional<Error> applyOperator(Operator op, const Value& firstOperand, const Value& secondOperand, Value& result) {
+	if (firstOperand.isInteger && secondOperand.isInteger) {
+		if (const auto integer{ applyIntegerOperator(op, firstOperand.integer, secondOperand.integer) }) {
+			result.integer = integer.value();
+			result.isInteger = true;
+			return std::nullopt;
+		}
+	}
+
+	const auto number{ applyOperator(op, toNumber(firstOperand), toNumber(secondOperand)) };
+	if (const auto error{ std::get_if<Error>(&number) }) {
+		return *error;
+	}
+	result.number = std::get<Number>(number);
+	result.isInteger = false;
+	return std::nullopt;
+}
+
+// integer operands and results are computed exactly on 64 bits (see Value), until an operation overflows
+// an empty expression fails with Error::MissingFormula
+// temporaries are allocated in evaluationArena
+EvaluationResult evaluate(const Expression& expression);
+
+// number of values of a variable evaluated at the same time by evaluateBatch
+constexpr std::size_t batchSize{ 256 };
+
+// evaluates expression once per value of variable, node by node over all the values, so that loops run over contiguous lanes
+// failures[i] is true if evaluating with variableValues[i] fails, results[i] is then meaningless (evaluate() tells why)
+// lanes are computed as Numbers only, so integers are exact as long as they fit into the mantissa of Number
+// assumes variableValues, results and failures have the same size, which is at most batchSize
+// temporaries are allocated in evaluationArena
+void evaluateBatch(const Expression& expression, SymbolTable::Slot variable, std::span<const Number> variableValues, std::span<Number> results, std::span<bool> failures);
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "ExpressionCache.hpp"
+
+thread_local ExpressionCache expressionCache{};
+
+CachedExpression::CachedExpression(Expression expression) noexcept :
+	expression{ std::move(expression) }
+{
+}
+
+EvaluationResult CachedExpression::evaluate() {
+	if (threadedCode.has_value()) {
+		return threadedCode->run();
+	}
+
+	if (++evaluations == hotEvaluations && !expression.nodes.empty()) {
+		threadedCode.emplace(expression);
+	}
+	return ::evaluate(expression);
+}
+
+CachedExpression* ExpressionCache::find(std::string_view formula) {
+	synchronize();
+
+	const auto entry{ index.find(formula) };
+	if (entry == index.cend()) {
+		stats.misses++;
+		return nullptr;
+	}
+
+	stats.hits++;
+	entries.splice(entries.begin(), entries, entry->second); // becomes the most recently used, iterators remain valid
+	return &entry->second->second;
+}
+
+void ExpressionCache::insert(std::string_view formula, Expression expression) {
+	synchronize();
+
+	if (maxSize == 0 || index.contains(formula)) {
+		return;
+	}
+
+	if (entries.size() == maxSize) {
+		evictLeastRecentlyUsed();
+	}
+	entries.emplace_front(formula, std::move(expression));
+	index.emplace(entries.front().first, entries.begin());
+}
+
+std::size_t ExpressionCache::size() const noexcept {
+	return entries.size();
+}
+
+const CacheStatistics& ExpressionCache::statistics() const noexcept {
+	return stats;
+}
+
+void ExpressionCache::setCapacity(std::size_t capacity) noexcept {
+	maxSize = capacity;
+}
+
+std::size_t ExpressionCache::capacity() noexcept {
+	return maxSize;
+}
+
+void ExpressionCache::invalidate() noexcept {
+	generation++;
+}
+
+void ExpressionCache::swap(ExpressionCache& other) noexcept {
+	std::swap(knownGeneration, other.knownGeneration);
+	std::swap(stats, other.stats);
+	entries.swap(other.entries); // iterators and keys of 'index' remain valid, they now refer to the other list
+	index.swap(other.index);
+}
+
+void ExpressionCache::synchronize() {
+	if (knownGeneration != generation) {
+		knownGeneration = generation;
+		index.clear();
+		entries.clear();
+	}
+
+	while (entries.size() > maxSize) {
+		evictLeastRecentlyUsed();
+	}
+}
+
+void ExpressionCache::evictLeastRecentlyUsed() {
+	index.erase(entries.back().first);
+	entries.pop_back();
+	stats.evictions++;
+}
\ No newline at end of file
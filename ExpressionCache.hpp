@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+
+#include "Expression.hpp"
+#include "ThreadedCode.hpp"
+
+struct CacheStatistics {
+	std::size_t hits{};
+	std::size_t misses{};
+	std::size_t evictions{};
+};
+
+// compiled expression of a cached formula, which is also compiled into threaded code once it is hot
+class CachedExpression {
+public:
+	// number of evaluations after which the threaded code is compiled
+	static constexpr std::size_t hotEvaluations{ 16 };
+
+	explicit CachedExpression(Expression expression) noexcept;
+
+	EvaluationResult evaluate();
+
+private:
+	Expression expression{};
+	std::optional<ThreadedCode> threadedCode{};
+	std::size_t evaluations{};
+};
+
+// least recently used cache of compiled expressions, keyed by the formula without its spaces
+// expressions refer to the slots of the variables they use, which never change, so they stay valid after a 'set' or a 'reset'
+// each thread has its own cache, but the capacity and invalidations are shared by all of them
+class ExpressionCache {
+public:
+	static constexpr std::size_t defaultCapacity{ 4096 };
+
+	// returns nullptr if the formula isn't cached
+	CachedExpression* find(std::string_view formula);
+
+	void insert(std::string_view formula, Expression expression);
+
+	std::size_t size() const noexcept;
+	const CacheStatistics& statistics() const noexcept;
+
+	// caches remove their least recently used expressions on their next use if there are more than 'capacity', 0 disables them
+	static void setCapacity(std::size_t capacity) noexcept;
+	static std::size_t capacity() noexcept;
+
+	// must be called when cached expressions may no longer match their formula
+	// caches are cleared on their next use
+	static void invalidate() noexcept;
+
+	// exchanges the expressions and statistics of two caches, e.g. to switch to another workspace
+	void swap(ExpressionCache& other) noexcept;
+
+private:
+	using Entry = std::pair<std::string, CachedExpression>;
+
+	// applies the last capacity change and invalidation
+	void synchronize();
+	void evictLeastRecentlyUsed();
+
+	static inline std::atomic<std::size_t> maxSize{ defaultCapacity };
+	static inline std::atomic<std::size_t> generation{}; // incremented by each invalidation
+
+	std::size_t knownGeneration{};
+	CacheStatistics stats{};
+	std::list<Entry> entries{}; // the most recently used comes first
+	std::unordered_map<std::string_view, std::list<Entry>::iterator> index{}; // keys are views on the formulas stored in 'entries'
+};
+
+extern thread_local ExpressionCache expressionCache;
\ No newline at end of file
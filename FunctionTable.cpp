@@ -0,0 +1,52 @@
+#include "FunctionTable.hpp"
+#include <algorithm>
+
+FunctionTable functions{};
+
+std::optional<FunctionTable::Id> FunctionTable::find(std::string_view name) const noexcept {
+	const auto id{ ids.find(name) };
+	if (id == ids.cend()) {
+		return std::nullopt;
+	}
+	return id->second;
+}
+
+bool FunctionTable::contains(std::string_view name) const noexcept {
+	return find(name).has_value();
+}
+
+void FunctionTable::define(std::string_view name, std::string definition, std::size_t parametersCount, Expression body) {
+	std::vector<SymbolTable::Slot> bodyVariables{};
+	for (const auto& node : body.nodes) {
+		if (node.type == NodeType::Variable && !isParameterSlot(node.variable)) {
+			bodyVariables.push_back(node.variable);
+		}
+	}
+	std::sort(bodyVariables.begin(), bodyVariables.end());
+	bodyVariables.erase(std::unique(bodyVariables.begin(), bodyVariables.end()), bodyVariables.end());
+
+	Function function{ std::move(definition), parametersCount, std::move(body), std::move(bodyVariables) };
+	if (const auto id{ find(name) }) {
+		definitions[id.value()] = std::move(function);
+		return;
+	}
+	ids.emplace(name, static_cast<Id>(definitions.size()));
+	definitions.push_back(std::move(function));
+}
+
+bool FunctionTable::isCallable(Id id) const noexcept {
+	const auto& bodyVariables{ definitions[id].variables };
+	return std::all_of(bodyVariables.cbegin(), bodyVariables.cend(), [](SymbolTable::Slot slot) { return variables.isDefined(slot); });
+}
+
+std::vector<FunctionTable::Id> FunctionTable::sortedIds() const {
+	std::vector<std::pair<std::string_view, Id>> namedIds(ids.cbegin(), ids.cend());
+	std::sort(namedIds.begin(), namedIds.end());
+
+	std::vector<Id> sorted{};
+	sorted.reserve(namedIds.size());
+	for (const auto& [name, id] : namedIds) {
+		sorted.push_back(id);
+	}
+	return sorted;
+}
\ No newline at end of file
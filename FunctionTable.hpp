@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Expression.hpp"
+#include "SymbolTable.hpp"
+
+// a function body refers to its i-th parameter with a NodeType::Variable node of slot parameterSlot(i), beyond the slots of
+// any symbol table, and to the other variables it uses with their slots
+constexpr std::size_t maxParameters{ 64 };
+constexpr SymbolTable::Slot firstParameterSlot{ std::numeric_limits<SymbolTable::Slot>::max() - maxParameters };
+
+constexpr SymbolTable::Slot parameterSlot(std::size_t parameter) noexcept {
+	return firstParameterSlot + static_cast<SymbolTable::Slot>(parameter);
+}
+
+constexpr bool isParameterSlot(SymbolTable::Slot slot) noexcept {
+	return slot >= firstParameterSlot && slot < firstParameterSlot + maxParameters;
+}
+
+struct Function {
+	std::string definition{};	// as displayed by 'list', e.g "f(x, y) = x^2 + y"
+	std::size_t parametersCount{};
+	Expression body{};			// compiled and optimized once, then copied where the function is called
+	std::vector<SymbolTable::Slot> variables{}; // used by the body, sorted and without duplicates
+};
+
+// functions defined with 'def', whose bodies are inlined where they are called so that a call costs as much as its body
+// a function calling another one inlines its body when it is defined, and keeps it if the other one is redefined
+class FunctionTable {
+public:
+	using Id = std::uint32_t;
+
+	std::optional<Id> find(std::string_view name) const noexcept;
+
+	bool contains(std::string_view name) const noexcept;
+
+	// creates or replaces a function, the variables used by its body are collected from it
+	void define(std::string_view name, std::string definition, std::size_t parametersCount, Expression body);
+
+	// assumes id is the one of a defined function
+	const Function& function(Id id) const noexcept {
+		return definitions[id];
+	}
+
+	// true if the variables used by the body of the function are all defined, so that it can be called
+	bool isCallable(Id id) const noexcept;
+
+	// ids of the functions, sorted by name
+	std::vector<Id> sortedIds() const;
+
+private:
+	struct NameHash {
+		using is_transparent = void;
+
+		std::size_t operator()(std::string_view name) const noexcept {
+			return std::hash<std::string_view>{}(name);
+		}
+	};
+
+	std::vector<Function> definitions{};
+	std::unordered_map<std::string, Id, NameHash, std::equal_to<>> ids{};
+};
+
+extern FunctionTable functions;
\ No newline at end of file
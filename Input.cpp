@@ -0,0 +1,44 @@
+#include "Input.hpp"
+#include "CharacterType.hpp"
+#include "SyntaxChecking.hpp"
+#include "ErrorsLogging.hpp"
+#include "Result.hpp"
+#include "Commands.hpp"
+#include "Output.hpp"
+#include "EvaluationArena.hpp"
+
+void processInput(const std::string& input) {
+	thread_local CommandArgs commandArgs{}; // reused, so that only the first commands allocate
+	setDiagnosticsInput(input);
+
+	if (input == "help") {
+		help();
+	}
+	else if (areAllCharactersSpaces(input)) { // all characters are spaces
+		output() << 0 << '\n';
+	}
+	else if (parseCommand(input, commandArgs)) {
+		const auto argumentErrors{ checkArguments(commandArgs) };
+		if (argumentErrors.has_value()) {
+			logError(argumentErrors.value().first, argumentErrors.value().second, input, commandArgs);
+		}
+		else {
+			executeCommand(commandArgs);
+		}
+	}
+	else if (isSyntaxCorrect(input)) {
+		const auto formulaResult{ result(input) };
+		if (const auto value{ std::get_if<Value>(&formulaResult) }) {
+			writeNumber(output(), toNumber(*value));
+			output() << '\n';
+		}
+		else {
+			logError(std::get<Error>(formulaResult), {}, input);
+		}
+	}
+	else {
+		checkSyntax(input);
+	}
+
+	evaluationArena.reset();
+}
\ No newline at end of file
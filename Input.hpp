@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+
+// evaluates a formula or executes a command (or 'help'), results are written into output()
+// 'quit' must be handled by the caller
+// evaluationArena is reset afterwards
+void processInput(const std::string& input);
\ No newline at end of file
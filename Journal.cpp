@@ -0,0 +1,421 @@
+#include "Journal.hpp"
+#include "MappedFile.hpp"
+#include "SaveFile.hpp"
+#include "SymbolTable.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+Journal journal{};
+
+constexpr std::array<char, 8> journalMagic{ 'C', 'A', 'L', 'C', 'J', 'R', 'N', 'L' };
+constexpr std::uint32_t journalVersion{ 1 };
+
+struct JournalHeader {
+	std::array<char, 8> magic{};
+	std::uint32_t version{};
+	std::uint32_t valueSize{}; // sizeof(Number) of the build which wrote the file
+};
+
+enum class RecordType : char {
+	Set = 's',		// followed by the value, then the name
+	Erase = 'e',	// followed by the name
+	Reset = 'r'		// all the variables are removed
+};
+
+// a record is this header, then its payload : its type, then its value and name if any
+// as the snapshot, it uses the byte order and the 'Number' representation of the machine which wrote it
+struct RecordHeader {
+	std::uint32_t size{};		// of the payload
+	std::uint32_t checksum{};	// of the payload
+};
+
+// FNV-1a
+static std::uint32_t checksum(std::string_view bytes) noexcept {
+	auto hash{ 2166136261u };
+	for (const auto c : bytes) {
+		hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+	}
+	return hash;
+}
+
+static void appendRecord(std::string& records, RecordType type, std::string_view name = {}, Number value = {}) {
+	const auto headerBegin{ records.size() };
+	records.resize(headerBegin + sizeof(RecordHeader));
+	records += static_cast<char>(type);
+	if (type == RecordType::Set) {
+		records.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+	records += name;
+
+	const std::string_view payload{ std::string_view{ records }.substr(headerBegin + sizeof(RecordHeader)) };
+	const RecordHeader header{ static_cast<std::uint32_t>(payload.size()), checksum(payload) };
+	std::memcpy(records.data() + headerBegin, &header, sizeof(header));
+}
+
+// variables of the snapshot modified by the journals, in the order of the snapshot then of their first record
+class SavedState {
+public:
+	// false if the snapshot exists but can't be read, no snapshot means no variables
+	bool readSnapshot() {
+		std::error_code error{};
+		if (!std::filesystem::exists(snapshotFileName, error)) {
+			return true;
+		}
+		return readSaveFile(std::string{ snapshotFileName }, [this](std::string_view name, Number value) { set(name, value); });
+	}
+
+	// applies the records of a journal, until the end or the first record which a crash left incomplete or corrupted
+	// returns the size of the valid part of the file, 0 if it doesn't exist, std::nullopt if it can't be read or isn't a journal
+	std::optional<std::uintmax_t> replay(std::string_view path) {
+		std::error_code error{};
+		if (!std::filesystem::exists(path, error)) {
+			return 0;
+		}
+
+		const MappedFile file{ std::string{ path } };
+		const auto content{ file.content() };
+		JournalHeader header{};
+		if (!file.isOpen() || content.size() < sizeof(header)) {
+			return std::nullopt;
+		}
+		std::memcpy(&header, content.data(), sizeof(header));
+		if (header.magic != journalMagic || header.version != journalVersion || header.valueSize != sizeof(Number)) {
+			return std::nullopt;
+		}
+
+		auto offset{ sizeof(header) };
+		while (content.size() - offset >= sizeof(RecordHeader)) {
+			RecordHeader recordHeader{};
+			std::memcpy(&recordHeader, content.data() + offset, sizeof(recordHeader));
+			const auto payloadBegin{ offset + sizeof(recordHeader) };
+			if (recordHeader.size > content.size() - payloadBegin) {
+				break;
+			}
+
+			const auto payload{ content.substr(payloadBegin, recordHeader.size) };
+			if (checksum(payload) != recordHeader.checksum || !apply(payload)) {
+				break;
+			}
+			offset = payloadBegin + recordHeader.size;
+		}
+		return offset;
+	}
+
+	// views on the names of the state, which must outlive them
+	std::vector<SavedVariable> variables() const {
+		std::vector<SavedVariable> savedVariables{};
+		savedVariables.reserve(entries.size());
+		for (const auto& [name, value] : entries) {
+			if (value.has_value()) {
+				savedVariables.push_back({ name, value.value() });
+			}
+		}
+		return savedVariables;
+	}
+
+private:
+	struct NameHash {
+		using is_transparent = void;
+
+		std::size_t operator()(std::string_view name) const noexcept {
+			return std::hash<std::string_view>{}(name);
+		}
+	};
+
+	void set(std::string_view name, std::optional<Number> value) {
+		const auto [index, isNew] { indexes.try_emplace(std::string{ name }, entries.size()) };
+		if (isNew) {
+			entries.emplace_back(name, value);
+		}
+		else {
+			entries[index->second].second = value;
+		}
+	}
+
+	// false if payload isn't a valid record
+	bool apply(std::string_view payload) {
+		if (payload.empty()) {
+			return false;
+		}
+
+		switch (static_cast<RecordType>(payload[0])) {
+		case RecordType::Set: {
+			if (payload.size() < 1 + sizeof(Number)) {
+				return false;
+			}
+			Number value{};
+			std::memcpy(&value, payload.data() + 1, sizeof(value));
+			set(payload.substr(1 + sizeof(value)), value);
+			return true;
+		}
+
+		case RecordType::Erase:
+			set(payload.substr(1), std::nullopt);
+			return true;
+
+		case RecordType::Reset:
+			entries.clear();
+			indexes.clear();
+			return true;
+		}
+		return false;
+	}
+
+	std::vector<std::pair<std::string, std::optional<Number>>> entries{}; // values are std::nullopt once erased
+	std::unordered_map<std::string, std::size_t, NameHash, std::equal_to<>> indexes{};
+};
+
+// creates an empty journal, nullptr if it can't be written
+static std::FILE* createJournal() {
+	std::FILE* file{ std::fopen(std::string{ journalFileName }.c_str(), "wb") };
+	const JournalHeader header{ journalMagic, journalVersion, sizeof(Number) };
+	if (file != nullptr && (std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fflush(file) != 0)) {
+		std::fclose(file);
+		return nullptr;
+	}
+	return file;
+}
+
+// merges 'vars.log.old', and 'vars.log' if includesJournal, into a new snapshot which replaces the previous one, then removes them
+// they are only removed once the new snapshot is complete, and replaying them again on top of it doesn't change it
+// returns the size of the new snapshot, std::nullopt if it can't be written
+static std::optional<std::uintmax_t> compact(bool includesJournal) {
+	SavedState state{};
+	if (!state.readSnapshot() || !state.replay(compactedJournalFileName).has_value() ||
+		(includesJournal && !state.replay(journalFileName).has_value())) {
+		return std::nullopt;
+	}
+
+	const std::string snapshotPath{ snapshotFileName };
+	if (!writeSnapshot(snapshotPath, state.variables())) {
+		return std::nullopt;
+	}
+
+	std::error_code error{};
+	std::filesystem::remove(compactedJournalFileName, error);
+	if (includesJournal) {
+		std::filesystem::remove(journalFileName, error);
+	}
+	const auto size{ std::filesystem::file_size(snapshotPath, error) };
+	return error ? std::nullopt : std::optional{ size };
+}
+
+Journal::~Journal() {
+	if (compaction.valid()) {
+		compaction.wait();
+	}
+	close();
+}
+
+bool Journal::start() {
+	const std::lock_guard lock{ mutex };
+	if (file != nullptr) {
+		return true;
+	}
+	if (compaction.valid()) {
+		compaction.wait();
+		collectCompaction();
+	}
+
+	// journals left by a previous process which weren't resumed would modify the new snapshot
+	std::error_code error{};
+	std::filesystem::remove(compactedJournalFileName, error);
+	std::filesystem::remove(journalFileName, error);
+
+	std::vector<SavedVariable> savedVariables{};
+	for (SymbolTable::Slot slot{}; slot < variables.slotCount(); slot++) {
+		if (variables.isDefined(slot) && !SymbolTable::isConstant(slot)) {
+			savedVariables.push_back({ variables.name(slot), variables.value(slot) });
+		}
+	}
+	if (!writeSnapshot(std::string{ snapshotFileName }, savedVariables)) {
+		return false;
+	}
+	std::filesystem::remove(textSaveFileName, error);
+
+	file = createJournal();
+	fileSize = sizeof(JournalHeader);
+	snapshotSize = std::filesystem::file_size(snapshotFileName, error);
+	compactionsCount = 0;
+	variables.clearModifications();
+	return file != nullptr;
+}
+
+bool Journal::resume() {
+	const std::lock_guard lock{ mutex };
+	if (file != nullptr) {
+		return true;
+	}
+
+	SavedState state{};
+	if (!state.readSnapshot() || !state.replay(compactedJournalFileName).has_value()) {
+		return false;
+	}
+	const auto journalSize{ state.replay(journalFileName) };
+	if (!journalSize.has_value()) {
+		return false;
+	}
+
+	for (const auto& variable : state.variables()) {
+		if (const auto slot{ variables.find(variable.name) }; !slot.has_value() || !SymbolTable::isConstant(slot.value())) {
+			variables.set(variable.name, toValue(variable.value));
+		}
+	}
+	variables.clearModifications();
+
+	// the records a crash left incomplete are removed, so that the next ones follow the valid ones
+	std::error_code error{};
+	if (journalSize.value() == 0) {
+		file = createJournal();
+		fileSize = sizeof(JournalHeader);
+	}
+	else {
+		std::filesystem::resize_file(journalFileName, journalSize.value(), error);
+		file = error ? nullptr : std::fopen(std::string{ journalFileName }.c_str(), "ab");
+		fileSize = journalSize.value();
+	}
+	snapshotSize = std::filesystem::exists(snapshotFileName, error) ? std::filesystem::file_size(snapshotFileName, error) : 0;
+	compactionsCount = 0;
+
+	// a compaction was interrupted
+	if (file != nullptr && std::filesystem::exists(compactedJournalFileName, error)) {
+		compaction = std::async(std::launch::async, compact, false);
+	}
+	return file != nullptr;
+}
+
+bool Journal::stop() {
+	const std::lock_guard lock{ mutex };
+	if (file == nullptr) {
+		return true;
+	}
+	if (compaction.valid()) {
+		compaction.wait();
+		collectCompaction();
+	}
+
+	close();
+	return compact(true).has_value();
+}
+
+JournalStatus Journal::status() {
+	const std::lock_guard lock{ mutex };
+	collectCompaction();
+	return { file != nullptr, file != nullptr ? fileSize : 0, compactionsCount, compaction.valid() };
+}
+
+bool Journal::recordModifications() {
+	const std::lock_guard lock{ mutex };
+	if (file == nullptr) {
+		variables.clearModifications();
+		return true;
+	}
+
+	records.clear();
+	if (variables.wasReset()) {
+		appendRecord(records, RecordType::Reset);
+	}
+	for (const auto slot : variables.modifiedSlots()) {
+		if (SymbolTable::isConstant(slot)) {
+			continue;
+		}
+		if (variables.isDefined(slot)) {
+			appendRecord(records, RecordType::Set, variables.name(slot), variables.value(slot));
+		}
+		else {
+			appendRecord(records, RecordType::Erase, variables.name(slot));
+		}
+	}
+	variables.clearModifications();
+	if (records.empty()) {
+		return true;
+	}
+
+	if (std::fwrite(records.data(), 1, records.size(), file) != records.size() || std::fflush(file) != 0) {
+		close();
+		return false;
+	}
+	fileSize += records.size();
+
+	collectCompaction();
+	if (fileSize >= std::max(minCompactionSize, snapshotSize) && !compaction.valid()) {
+		return startCompaction();
+	}
+	return true;
+}
+
+void Journal::waitForCompaction() {
+	const std::lock_guard lock{ mutex };
+	if (compaction.valid()) {
+		compaction.wait();
+		collectCompaction();
+	}
+}
+
+void Journal::collectCompaction() {
+	if (!compaction.valid() || compaction.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+		return;
+	}
+
+	// if it failed, 'vars.log.old' is kept, and merged again by the next compaction
+	if (const auto newSnapshotSize{ compaction.get() }) {
+		snapshotSize = newSnapshotSize.value();
+		compactionsCount++;
+	}
+}
+
+// the journal is renamed, so that records are appended into a new one while it is merged
+bool Journal::startCompaction() {
+	std::error_code error{};
+	if (!std::filesystem::exists(compactedJournalFileName, error)) {
+		std::fclose(file);
+		std::filesystem::rename(journalFileName, compactedJournalFileName, error);
+		if (error) {
+			file = std::fopen(std::string{ journalFileName }.c_str(), "ab");
+			return file != nullptr;
+		}
+
+		file = createJournal();
+		fileSize = sizeof(JournalHeader);
+		if (file == nullptr) {
+			return false;
+		}
+	}
+
+	compaction = std::async(std::launch::async, compact, false);
+	return true;
+}
+
+void Journal::close() {
+	if (file != nullptr) {
+		std::fclose(file);
+		file = nullptr;
+	}
+}
+
+bool hasJournal() {
+	std::error_code error{};
+	return std::filesystem::exists(journalFileName, error) || std::filesystem::exists(compactedJournalFileName, error);
+}
+
+bool readSavedVariables(const std::string& path, const std::function<void(std::string_view name, Number value)>& callback) {
+	if (path != snapshotFileName || !hasJournal()) {
+		return readSaveFile(path, callback);
+	}
+
+	journal.waitForCompaction();
+	SavedState state{};
+	if (!state.readSnapshot() || !state.replay(compactedJournalFileName).has_value() || !state.replay(journalFileName).has_value()) {
+		return false;
+	}
+	for (const auto& variable : state.variables()) {
+		callback(variable.name, variable.value);
+	}
+	return true;
+}
\ No newline at end of file
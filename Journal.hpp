@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Number.hpp"
+
+constexpr std::string_view journalFileName{ "vars.log" };
+
+// journal being merged into the snapshot by a compaction, while the new records are appended into a new 'vars.log'
+constexpr std::string_view compactedJournalFileName{ "vars.log.old" };
+
+// smallest journal which is compacted : larger snapshots are only rewritten once the journal is as large as them,
+// so that compactions cost O(1) per record, whatever the number of variables
+constexpr std::uintmax_t minCompactionSize{ 1 << 20 };
+
+struct JournalStatus {
+	bool isActive{};
+	std::uintmax_t size{};		// of 'vars.log', 0 if the journal isn't active
+	std::size_t compactions{};	// done since the journal was started or resumed
+	bool isCompacting{};
+};
+
+// incremental save : once started, the variables modified by each command are appended as records to 'vars.log', on top
+// of the snapshot 'vars.bin', so that saving a variable writes a record rather than all the variables
+// records are checksummed, so that a record partially written by a crash is ignored when reading the journal back,
+// the compaction replaces the snapshot atomically before removing the journal it merged, which can be replayed twice
+// only the values of the variables are saved, as with 'save', not the formulas they are bound to nor the functions
+// as the other save files, they aren't synced to the disk : a crash of the process loses no record, whereas a crash of the
+// system may lose the last ones
+class Journal {
+public:
+	Journal() = default;
+	~Journal(); // waits for the running compaction
+
+	Journal(const Journal&) = delete;
+	Journal& operator=(const Journal&) = delete;
+
+	// writes the snapshot of all the variables, then an empty journal
+	// false if they can't be written
+	bool start();
+
+	// replays the snapshot and the journal left by a previous process into 'variables', then appends to the journal
+	// false if they can't be read or written
+	bool resume();
+
+	// merges the journal into the snapshot, which becomes an ordinary save file, then removes the journal
+	// false if it can't be merged, the journal is then kept and can be resumed
+	bool stop();
+
+	JournalStatus status();
+
+	// appends a record per variable modified since the last call, with a single write, then compacts the journal in another
+	// thread if it is large enough, modifications are only forgotten if the journal isn't active
+	// false if the records can't be written, the journal is then stopped
+	bool recordModifications();
+
+	// waits for the running compaction, if any
+	void waitForCompaction();
+
+private:
+	// must be called with mutex locked
+	void collectCompaction();
+	bool startCompaction(); // false if the new journal can't be created, the journal is then stopped
+	void close();
+
+	std::mutex mutex{};
+	std::FILE* file{};
+	std::uintmax_t fileSize{};
+	std::uintmax_t snapshotSize{};
+	std::future<std::optional<std::uintmax_t>> compaction{}; // size of the new snapshot, std::nullopt if it failed
+	std::size_t compactionsCount{};
+	std::string records{}; // reused, so that only the first modifications allocate
+};
+
+extern Journal journal;
+
+// true if a journal was left by a previous process, or is active
+bool hasJournal();
+
+// same as readSaveFile, but the variables of the snapshot are the ones modified by the journal, if there is one
+// waits for the running compaction, if any
+bool readSavedVariables(const std::string& path, const std::function<void(std::string_view name, Number value)>& callback);
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "Lexer.hpp"
+#include "FunctionTable.hpp"
+#include "PipelineStatistics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+void tokenize(std::string_view formula, std::pmr::vector<Token>& tokens, std::span<const std::string_view> parameters) {
+	const StageTimer timer{ Stage::Tokenize };
+	tokens.clear();
+
+	for (std::size_t i{}; i < formula.size(); i++) {
+		const char c{ formula[i] };
+
+		if (isDigit(c) || c == '.') {
+			// the whole sequence is skipped, but only its valid prefix is read => "1.5.5" is read as 1.5
+			const auto numberEnd{ std::find_if_not(formula.cbegin() + static_cast<std::ptrdiff_t>(i), formula.cend(), [](char character) { return isDigit(character) || character == '.'; }) };
+			const auto numberBegin{ formula.data() + i };
+			const auto numberLast{ formula.data() + (numberEnd - formula.cbegin()) };
+			Value number{};
+			std::int64_t integer{};
+
+			// integers are read exactly, if they fit into 64 bits
+			if (const auto [end, error] { std::from_chars(numberBegin, numberLast, integer) }; error == std::errc{} && end == numberLast) {
+				number = integerValue(integer);
+			}
+			else if (number::fromChars(numberBegin, formula.data() + formula.size(), number.number).ec == std::errc::result_out_of_range) {
+				number.number = number::huge;
+			}
+			tokens.push_back({ .type = TokenType::Number, .number = number });
+			i = static_cast<std::size_t>(numberEnd - formula.cbegin()) - 1;
+		}
+		else if (std::isalpha(c) || c == '_') {
+			const auto identifierEnd{ std::find_if_not(formula.cbegin() + static_cast<std::ptrdiff_t>(i), formula.cend(), [](char character) { return std::isalpha(character) || character == '_'; }) };
+			const auto identifier{ formula.substr(i, static_cast<std::size_t>(identifierEnd - formula.cbegin()) - i) };
+			// it is an existing parameter, variable or function because syntax was checked
+			if (const auto parameter{ std::find(parameters.begin(), parameters.end(), identifier) }; parameter != parameters.end()) {
+				tokens.push_back({ .type = TokenType::Variable, .variable = parameterSlot(static_cast<std::size_t>(parameter - parameters.begin())) });
+			}
+			else if (const auto variable{ variables.find(identifier) }) {
+				tokens.push_back({ .type = TokenType::Variable, .variable = variable.value() });
+			}
+			else {
+				tokens.push_back({ .type = TokenType::Function, .function = functions.find(identifier).value() });
+			}
+			i += identifier.size() - 1;
+		}
+		else if (isOperator(c)) {
+			tokens.push_back({ .type = TokenType::Operator, .op = static_cast<Operator>(c) });
+		}
+		else if (isOpeningDelimiter(c)) {
+			tokens.push_back({ .type = TokenType::OpeningDelimiter });
+		}
+		else if (isClosingDelimiter(c)) {
+			tokens.push_back({ .type = TokenType::ClosingDelimiter });
+		}
+		else if (isArgumentSeparator(c)) {
+			tokens.push_back({ .type = TokenType::ArgumentSeparator });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "CharacterType.hpp"
+#include "SymbolTable.hpp"
+#include "Value.hpp"
+
+enum class Operator : char {
+	Modulo = '%',
+	Plus = '+',
+	Minus = '-',
+	Multiply = '*',
+	Divide = '/',
+	Power = '^'
+};
+
+// follows the order of the 'operators' string : '%' has the lowest priority (1), '^' the highest (6)
+constexpr std::size_t operatorPriority(Operator op) noexcept {
+	return operators.find(static_cast<char>(op)) + 1;
+}
+
+enum class TokenType {
+	Number,
+	Operator,
+	OpeningDelimiter,
+	ClosingDelimiter,
+	ArgumentSeparator,
+	Variable,
+	Function		// always followed by the opening delimiter of its arguments
+};
+
+struct Token {
+	TokenType type{};
+	Operator op{};					// only for TokenType::Operator
+	Value number{};					// only for TokenType::Number
+	SymbolTable::Slot variable{};	// only for TokenType::Variable, slot of the variable in 'variables', or parameterSlot(i) for parameters[i]
+	std::uint32_t function{};		// only for TokenType::Function, id of the function in 'functions'
+};
+
+// writes into tokens, which is cleared first
+// parameters are the ones of the function whose body is formula, if any : they hide the variables of the same name
+// assumes syntax was checked previously, spaces were removed, implicit '*' were added and '+' / '-' were simplified
+void tokenize(std::string_view formula, std::pmr::vector<Token>& tokens, std::span<const std::string_view> parameters = {});
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		fileHandle = nullptr;
+		return;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		return;
+	}
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	if (size == 0) { // an empty file can't be mapped
+		opened = true;
+		return;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		return;
+	}
+	data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	opened = data != nullptr;
+}
+
+MappedFile::~MappedFile() {
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+	fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1) {
+		return;
+	}
+
+	struct stat fileStatus {};
+	if (::fstat(fileDescriptor, &fileStatus) == -1) {
+		return;
+	}
+	size = static_cast<std::size_t>(fileStatus.st_size);
+	if (size == 0) { // an empty file can't be mapped
+		opened = true;
+		return;
+	}
+
+	void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+	if (mapping == MAP_FAILED) {
+		return;
+	}
+	::madvise(mapping, size, MADV_SEQUENTIAL);
+	data = static_cast<const char*>(mapping);
+	opened = true;
+}
+
+MappedFile::~MappedFile() {
+	if (data != nullptr) {
+		::munmap(const_cast<char*>(data), size);
+	}
+	if (fileDescriptor != -1) {
+		::close(fileDescriptor);
+	}
+}
+
+#endif
+
+bool MappedFile::isOpen() const noexcept {
+	return opened;
+}
+
+std::string_view MappedFile::content() const noexcept {
+	if (data == nullptr) {
+		return {};
+	}
+	return { data, size };
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// read-only view of a whole file mapped in memory
+class MappedFile {
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// false if the file couldn't be opened or mapped
+	bool isOpen() const noexcept;
+
+	std::string_view content() const noexcept;
+
+private:
+	bool opened{};
+	const char* data{};
+	std::size_t size{};
+#ifdef _WIN32
+	void* fileHandle{};
+	void* mappingHandle{};
+#else
+	int fileDescriptor{ -1 };
+#endif
+};
\ No newline at end of file
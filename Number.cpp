@@ -0,0 +1,104 @@
+#include "Number.hpp"
+
+#if defined(CALCULATOR_PRECISION_FLOAT128)
+#include <cerrno>
+#include <string>
+
+std::from_chars_result number::fromChars(const char* first, const char* last, Number& value) noexcept {
+	// std::from_chars doesn't accept spaces nor a '+' sign, but strtoflt128 does
+	if (first == last || *first == '+' || std::isspace(static_cast<unsigned char>(*first))) {
+		return { first, std::errc::invalid_argument };
+	}
+
+	const std::string text(first, last); // strtoflt128 needs a null-terminated string
+	char* end{};
+	errno = 0;
+	const auto parsedValue{ strtoflt128(text.c_str(), &end) };
+	const auto parsedEnd{ first + (end - text.c_str()) };
+
+	if (parsedEnd == first) {
+		return { first, std::errc::invalid_argument };
+	}
+	if (errno == ERANGE) {
+		return { parsedEnd, std::errc::result_out_of_range };
+	}
+	value = parsedValue;
+	return { parsedEnd, std::errc{} };
+}
+
+std::to_chars_result number::toChars(char* first, char* last, Number value, int precision) noexcept {
+	const auto size{ quadmath_snprintf(first, static_cast<std::size_t>(last - first), "%.*Qg", precision, value) };
+	if (size < 0 || size >= last - first) { // quadmath_snprintf needs room for the null character
+		return { last, std::errc::value_too_large };
+	}
+	return { first + size, std::errc{} };
+}
+
+// significant digits which always identify a __float128, quadmath.h doesn't define FLT128_DECIMAL_DIG
+constexpr int float128DecimalDigits{ 36 };
+
+std::to_chars_result number::toChars(char* first, char* last, Number value) noexcept {
+	// there is no shortest formatting of __float128 : the precision is increased until the value is read back,
+	// FLT128_DIG digits are enough for most values, as they come from short decimal texts
+	for (int precision{ FLT128_DIG }; precision < float128DecimalDigits; precision++) {
+		const auto result{ toChars(first, last, value, precision) };
+		Number readValue{};
+		if (result.ec != std::errc{} || (fromChars(first, result.ptr, readValue).ec == std::errc{} && readValue == value)) {
+			return result;
+		}
+	}
+	return toChars(first, last, value, float128DecimalDigits);
+}
+
+#else
+#include <cstdint>
+
+std::from_chars_result number::fromChars(const char* first, const char* last, Number& value) noexcept {
+	return std::from_chars(first, last, value);
+}
+
+std::to_chars_result number::toChars(char* first, char* last, Number value) noexcept {
+	return std::to_chars(first, last, value, std::chars_format::general);
+}
+
+#if defined(CALCULATOR_PRECISION_DOUBLE)
+
+std::to_chars_result number::toChars(char* first, char* last, Number value, int precision) noexcept {
+	return std::to_chars(first, last, value, std::chars_format::general, precision);
+}
+
+#else
+
+// std::to_chars is several times slower for long double than for double, so long doubles are formatted as the nearest double
+// when both are rounded to the same text : they differ by less than 2^-53 times their value, so it is the case unless
+// this double is that close to the middle of two numbers of 'precision' significant digits
+static bool isRoundedAsDouble(double value, int precision) noexcept {
+	constexpr int checkedDigits{ 17 };
+	if (precision < 1 || precision > checkedDigits - 3 || !std::isnormal(value)) { // also false if the long double is out of the range of double
+		return false;
+	}
+
+	// "d.dddddddddddddddde+XX" : the digits after the first 'precision' ones are compared to the middle of their range
+	char text[32];
+	std::to_chars(text, text + sizeof(text), std::abs(value), std::chars_format::scientific, checkedDigits - 1);
+	std::int64_t remainingDigits{};
+	std::int64_t middle{}; // "5000..."
+	for (int i{ precision + 1 }; i <= checkedDigits; i++) { // the digit i is text[i], after the first one and the point
+		remainingDigits = remainingDigits * 10 + (text[i] - '0');
+		middle = middle * 10 + (i == precision + 1 ? 5 : 0);
+	}
+
+	// less than 11 units of the last digit between the long double and the double, and half a unit of rounding of the text
+	return std::abs(remainingDigits - middle) > 12;
+}
+
+std::to_chars_result number::toChars(char* first, char* last, Number value, int precision) noexcept {
+	if (const auto nearest{ static_cast<double>(value) }; value == 0 || isRoundedAsDouble(nearest, precision)) {
+		return std::to_chars(first, last, nearest, std::chars_format::general, precision);
+	}
+	return std::to_chars(first, last, value, std::chars_format::general, precision);
+}
+
+#endif
+
+#endif
\ No newline at end of file
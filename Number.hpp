@@ -0,0 +1,76 @@
+#pragma once
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+// numeric type of the evaluation engine and of the variables, chosen when building with the CALCULATOR_PRECISION CMake option :
+// 'double', 'long double' (the default) or '__float128' (GCC only, uses libquadmath)
+#if defined(CALCULATOR_PRECISION_FLOAT128)
+#include <quadmath.h>
+using Number = __float128;
+#elif defined(CALCULATOR_PRECISION_DOUBLE)
+using Number = double;
+#else
+using Number = long double;
+#endif
+
+// math functions and conversions of Number, as the standard library doesn't support __float128
+namespace number {
+#if defined(CALCULATOR_PRECISION_FLOAT128)
+	// parsed rather than written with the 'Q' suffix, which is rejected by -Wpedantic
+	inline const Number e{ strtoflt128("2.718281828459045235360287471352662498", nullptr) };
+	inline const Number pi{ strtoflt128("3.141592653589793238462643383279502884", nullptr) };
+	constexpr Number huge{ HUGE_VALQ };
+
+	inline Number pow(Number base, Number exponent) noexcept {
+		return powq(base, exponent);
+	}
+
+	inline Number fmod(Number dividend, Number divisor) noexcept {
+		return fmodq(dividend, divisor);
+	}
+
+	inline Number trunc(Number value) noexcept {
+		return truncq(value);
+	}
+
+	inline Number floor(Number value) noexcept {
+		return floorq(value);
+	}
+
+	inline bool isfinite(Number value) noexcept {
+		return finiteq(value);
+	}
+
+	inline bool signbit(Number value) noexcept {
+		return signbitq(value) != 0;
+	}
+#else
+	constexpr Number e{ std::numbers::e_v<Number> };
+	constexpr Number pi{ std::numbers::pi_v<Number> };
+	constexpr Number huge{ std::numeric_limits<Number>::infinity() };
+
+	using std::pow;
+	using std::fmod;
+	using std::trunc;
+	using std::floor;
+	using std::isfinite;
+	using std::signbit;
+#endif
+
+	// significant digits of the displayed results, the default precision of the standard streams
+	constexpr int displayPrecision{ 6 };
+
+	// large enough for any Number written by toChars
+	constexpr std::size_t maxCharsSize{ 64 };
+
+	// same as std::from_chars in its general format
+	std::from_chars_result fromChars(const char* first, const char* last, Number& value) noexcept;
+
+	// shortest text which fromChars reads back as exactly the same value, in the general format
+	std::to_chars_result toChars(char* first, char* last, Number value) noexcept;
+
+	// same as std::to_chars in the general format, or printf's "%.<precision>g"
+	std::to_chars_result toChars(char* first, char* last, Number value, int precision) noexcept;
+}
\ No newline at end of file
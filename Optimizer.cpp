@@ -0,0 +1,237 @@
+#include "Optimizer.hpp"
+#include "EvaluationArena.hpp"
+#include "PipelineStatistics.hpp"
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+// what a node of the original expression became
+struct OptimizedNode {
+	std::optional<Value> constant{};	// its value, if it can be computed once for all
+	std::size_t index{};					// its index in the optimized expression, only if it was written into it
+	bool isWritten{};
+};
+
+// same value with the same representation : 0 and -0 aren't identical, as 1/0 and 1/-0 differ, and NaN is never identical
+static bool isIdentical(const Value& first, const Value& second) noexcept {
+	if (first.isInteger || second.isInteger) {
+		return first.isInteger == second.isInteger && first.integer == second.integer;
+	}
+	return first.number == second.number && number::signbit(first.number) == number::signbit(second.number);
+}
+
+// nodes of the optimized expression are identical if they have the same content, as their operands are shared already :
+// they are then structurally identical subexpressions, whatever their delimiters, which don't make nodes
+struct IdenticalNodes {
+	std::size_t operator()(const Node& node) const noexcept {
+		std::size_t hash{ static_cast<std::size_t>(node.type) };
+		const auto combine = [&hash](std::size_t value) {
+			hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+		};
+
+		switch (node.type) {
+		case NodeType::Number: // Numbers are hashed through double, as there is no std::hash<__float128>
+			combine(node.number.isInteger ? std::hash<std::int64_t>{}(node.number.integer) : std::hash<double>{}(static_cast<double>(node.number.number)));
+			break;
+
+		case NodeType::Variable:
+			combine(node.variable);
+			break;
+
+		case NodeType::Negate:
+			combine(node.left);
+			break;
+
+		case NodeType::Operation:
+			combine(static_cast<std::size_t>(node.op));
+			combine(node.left);
+			combine(node.right);
+			break;
+		}
+		return hash;
+	}
+
+	bool operator()(const Node& first, const Node& second) const noexcept {
+		if (first.type != second.type) {
+			return false;
+		}
+
+		switch (first.type) {
+		case NodeType::Number:
+			return isIdentical(first.number, second.number);
+
+		case NodeType::Variable:
+			return first.variable == second.variable;
+
+		case NodeType::Negate:
+			return first.left == second.left;
+
+		default:
+			return first.op == second.op && first.left == second.left && first.right == second.right;
+		}
+	}
+};
+
+// only keeps the nodes the root depends on, some may have become useless after a simplification
+static Expression removeUnusedNodes(const Expression& expression, std::size_t root) {
+	// operands always come before their operator, so nodes after the root are unused, and the root becomes the last node
+	std::pmr::vector<bool> isUsed(root + 1, false, evaluationArena.resource());
+	isUsed[root] = true;
+	for (auto i{ root + 1 }; i-- > 0;) {
+		const auto& node{ expression.nodes[i] };
+		if (isUsed[i] && (node.type == NodeType::Negate || node.type == NodeType::Operation)) {
+			isUsed[node.left] = true;
+			isUsed[node.right] = isUsed[node.right] || node.type == NodeType::Operation;
+		}
+	}
+
+	Expression usedExpression{};
+	std::pmr::vector<std::size_t> newIndexes(root + 1, evaluationArena.resource());
+	for (std::size_t i{}; i <= root; i++) {
+		if (isUsed[i]) {
+			auto node{ expression.nodes[i] };
+			node.left = newIndexes[node.left];
+			node.right = newIndexes[node.right];
+			newIndexes[i] = usedExpression.nodes.size();
+			usedExpression.nodes.push_back(node);
+		}
+	}
+	return usedExpression;
+}
+
+Expression optimize(const Expression& expression) {
+	const StageTimer timer{ Stage::Optimize };
+	Expression optimizedExpression{};
+	std::pmr::vector<OptimizedNode> optimizedNodes(expression.nodes.size(), evaluationArena.resource());
+
+	// hash-consing : a node identical to a written one isn't written again, the written one is shared and evaluated once
+	std::pmr::unordered_map<Node, std::size_t, IdenticalNodes, IdenticalNodes> writtenNodes{ expression.nodes.size(), evaluationArena.resource() };
+	std::size_t deduplicatedNodes{};
+
+	// for each written node, whether its evaluation may fail, i.e. a division or a modulo is computed under it
+	std::pmr::vector<bool> mayFail(evaluationArena.resource());
+
+	const auto write = [&optimizedExpression, &writtenNodes, &deduplicatedNodes, &mayFail](const Node& node) {
+		const auto [writtenNode, isNew] { writtenNodes.try_emplace(node, optimizedExpression.nodes.size()) };
+		if (isNew) {
+			optimizedExpression.nodes.push_back(node);
+			mayFail.push_back((node.type == NodeType::Negate && mayFail[node.left]) || (node.type == NodeType::Operation &&
+				(node.op == Operator::Divide || node.op == Operator::Modulo || mayFail[node.left] || mayFail[node.right])));
+		}
+		else {
+			deduplicatedNodes++;
+		}
+		return OptimizedNode{ .index = writtenNode->second, .isWritten = true };
+	};
+
+	// constants are only written when an operator which couldn't be computed uses them
+	const auto operandIndex = [&optimizedExpression, &write](OptimizedNode& operand) {
+		if (!operand.isWritten) {
+			operand.index = write({ .type = NodeType::Number, .number = operand.constant.value() }).index;
+			operand.isWritten = true;
+		}
+		return operand.index;
+	};
+
+	// base^exponent, with 2 <= exponent <= maxUnrolledPower, by repeated squaring
+	const auto unrollPower = [&write](std::size_t base, std::int64_t exponent) {
+		std::optional<std::size_t> result{};
+		for (auto remaining{ static_cast<unsigned>(exponent) }; remaining != 0; remaining /= 2) {
+			if (remaining % 2 == 1) {
+				result = result.has_value() ? write({ .type = NodeType::Operation, .op = Operator::Multiply, .left = result.value(), .right = base }).index : base;
+			}
+			if (remaining > 1) {
+				base = write({ .type = NodeType::Operation, .op = Operator::Multiply, .left = base, .right = base }).index;
+			}
+		}
+		return result.value();
+	};
+
+	for (std::size_t i{}; i < expression.nodes.size(); i++) {
+		const auto& node{ expression.nodes[i] };
+		auto& optimizedNode{ optimizedNodes[i] };
+
+		switch (node.type) {
+		case NodeType::Number:
+			optimizedNode.constant = node.number;
+			break;
+
+		case NodeType::Variable:
+			if (SymbolTable::isConstant(node.variable)) {
+				optimizedNode.constant = variables.exactValue(node.variable);
+			}
+			else {
+				optimizedNode = write(node);
+			}
+			break;
+
+		case NodeType::Negate: {
+			auto& operand{ optimizedNodes[node.left] };
+			if (operand.constant.has_value()) {
+				optimizedNode.constant = negate(operand.constant.value());
+			}
+			else if (const auto& operandNode{ optimizedExpression.nodes[operand.index] }; operandNode.type == NodeType::Negate) {
+				optimizedNode = { .index = operandNode.left, .isWritten = true }; // --x => x
+			}
+			else {
+				optimizedNode = write({ .type = NodeType::Negate, .left = operand.index });
+			}
+			break;
+		}
+
+		case NodeType::Operation: {
+			auto& left{ optimizedNodes[node.left] };
+			auto& right{ optimizedNodes[node.right] };
+			const auto isLeft = [&left](Number value) { return left.constant.has_value() && toNumber(left.constant.value()) == value; };
+			const auto isRight = [&right](Number value) { return right.constant.has_value() && toNumber(right.constant.value()) == value; };
+
+			if (left.constant.has_value() && right.constant.has_value()) {
+				if (Value value{}; !applyOperator(node.op, left.constant.value(), right.constant.value(), value).has_value()) { // errors are left to the evaluation
+					optimizedNode.constant = value;
+					break;
+				}
+			}
+
+			// x + 0 isn't x when x is -0, as -0 + 0 is 0 : only -0 is neutral for additions, and only 0 for subtractions
+			const auto isLeftZero = [&left, &isLeft](bool isNegative) { return isLeft(0) && number::signbit(toNumber(left.constant.value())) == isNegative; };
+			const auto isRightZero = [&right, &isRight](bool isNegative) { return isRight(0) && number::signbit(toNumber(right.constant.value())) == isNegative; };
+
+			const bool isRightNeutral{
+				(node.op == Operator::Plus && isRightZero(true)) || (node.op == Operator::Minus && isRightZero(false)) ||
+				(node.op == Operator::Multiply && isRight(1)) || (node.op == Operator::Divide && isRight(1)) ||
+				(node.op == Operator::Power && isRight(1))
+			};
+			const bool isLeftNeutral{ (node.op == Operator::Plus && isLeftZero(true)) || (node.op == Operator::Multiply && isLeft(1)) };
+
+			if (isRightNeutral) {
+				optimizedNode = left;
+			}
+			else if (isLeftNeutral) {
+				optimizedNode = right;
+			}
+			// even for an infinite or NaN left operand, but not for one which fails, as the error is left to the evaluation
+			else if (node.op == Operator::Power && isRight(0) && (!left.isWritten || !mayFail[left.index])) {
+				optimizedNode.constant = integerValue(1);
+			}
+			else if (node.op == Operator::Power && right.constant.has_value() && right.constant.value().isInteger &&
+				right.constant.value().integer >= 2 && right.constant.value().integer <= maxUnrolledPower) {
+				optimizedNode = { .index = unrollPower(operandIndex(left), right.constant.value().integer), .isWritten = true };
+			}
+			else {
+				const auto leftIndex{ operandIndex(left) };
+				const auto rightIndex{ operandIndex(right) };
+				optimizedNode = write({ .type = NodeType::Operation, .op = node.op, .left = leftIndex, .right = rightIndex });
+			}
+			break;
+		}
+		}
+	}
+
+	if (optimizedNodes.empty()) {
+		return optimizedExpression;
+	}
+	const auto root{ operandIndex(optimizedNodes.back()) };
+	countDeduplicatedNodes(deduplicatedNodes);
+	return removeUnusedNodes(optimizedExpression, root);
+}
\ No newline at end of file
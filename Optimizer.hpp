@@ -0,0 +1,18 @@
+#pragma once
+#include "Expression.hpp"
+
+// highest integer power computed with multiplications instead of number::pow
+constexpr std::int64_t maxUnrolledPower{ 8 };
+
+// rewrites a parsed expression so that it is cheaper to evaluate repeatedly, with the same errors and the same value, except
+// for the last bits of the unrolled powers :
+//	- subexpressions using only numbers, e and pi are computed once, unless they fail (division by zero, ...)
+//	- identities are removed : x*1, 1*x, x+(-0), (-0)+x, x-0, x/1, x^1, --x (x+0 isn't, as it is 0 when x is -0)
+//	- x^0 becomes 1, unless x may fail, i.e. it computes a division or a modulo
+//	- integer powers up to maxUnrolledPower become multiplications => x^4 is computed as (x*x)*(x*x), which may round
+//	  differently than number::pow
+//	- identical subexpressions are written once and shared => in "(a+b*c)^2 + 3(a+b*c) + [a+b*c]", a+b*c is computed once
+// 0*x isn't simplified, as the value of x may be infinite or NaN
+// temporaries are allocated in evaluationArena
+// the result may share nodes between several operands, so it is no longer a tree but a directed acyclic graph
+Expression optimize(const Expression& expression);
\ No newline at end of file
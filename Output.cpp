@@ -0,0 +1,92 @@
+#include "Output.hpp"
+#include <iostream>
+
+static thread_local std::ostream* currentOutput{ &std::cout };
+static thread_local std::ostream* currentErrorOutput{ &std::cerr };
+
+BufferedWriter::BufferedWriter(std::FILE* file, std::size_t bufferSize) :
+	file{ file },
+	buffer(bufferSize)
+{
+	setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+BufferedWriter::~BufferedWriter() {
+	sync();
+}
+
+BufferedWriter::int_type BufferedWriter::overflow(int_type c) {
+	if (!writeBuffer()) {
+		return traits_type::eof();
+	}
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+	return traits_type::not_eof(c);
+}
+
+int BufferedWriter::sync() {
+	return writeBuffer() && std::fflush(file) == 0 ? 0 : -1;
+}
+
+bool BufferedWriter::writeBuffer() {
+	const auto size{ static_cast<std::size_t>(pptr() - pbase()) };
+	const bool success{ std::fwrite(pbase(), 1, size, file) == size };
+	setp(buffer.data(), buffer.data() + buffer.size());
+	return success;
+}
+
+std::string_view StringWriter::view() const noexcept {
+	return text;
+}
+
+void StringWriter::clear() noexcept {
+	text.clear();
+}
+
+StringWriter::int_type StringWriter::overflow(int_type c) {
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		text += traits_type::to_char_type(c);
+	}
+	return traits_type::not_eof(c);
+}
+
+std::streamsize StringWriter::xsputn(const char* characters, std::streamsize count) {
+	text.append(characters, static_cast<std::size_t>(count));
+	return count;
+}
+
+void writeNumber(std::ostream& stream, Number value) {
+	char buffer[number::maxCharsSize];
+	const auto end{ number::toChars(buffer, buffer + sizeof(buffer), value, number::displayPrecision).ptr };
+	stream.write(buffer, end - buffer);
+}
+
+std::ostream& output() {
+	return *currentOutput;
+}
+
+std::ostream& errorOutput() {
+	return *currentErrorOutput;
+}
+
+OutputRedirection::OutputRedirection(std::ostream& stream) :
+	previousStream{ currentOutput }
+{
+	currentOutput = &stream;
+}
+
+OutputRedirection::~OutputRedirection() {
+	currentOutput = previousStream;
+}
+
+ErrorOutputRedirection::ErrorOutputRedirection(std::ostream& stream) :
+	previousStream{ currentErrorOutput }
+{
+	currentErrorOutput = &stream;
+}
+
+ErrorOutputRedirection::~ErrorOutputRedirection() {
+	currentErrorOutput = previousStream;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Number.hpp"
+
+// stream buffer writing into a file only when its (large) buffer is full, or when explicitly flushed
+class BufferedWriter : public std::streambuf {
+public:
+	static constexpr std::size_t defaultBufferSize{ 1 << 20 };
+
+	explicit BufferedWriter(std::FILE* file, std::size_t bufferSize = defaultBufferSize);
+	~BufferedWriter() override;
+
+	BufferedWriter(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+protected:
+	int_type overflow(int_type c) override;
+	int sync() override;
+
+private:
+	bool writeBuffer();
+
+	std::FILE* file{};
+	std::vector<char> buffer{};
+};
+
+// stream buffer appending into a string, which keeps its capacity when cleared so that it can be reused without allocating
+class StringWriter : public std::streambuf {
+public:
+	std::string_view view() const noexcept;
+	void clear() noexcept;
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char* characters, std::streamsize count) override;
+
+private:
+	std::string text{};
+};
+
+// writes value as the results are displayed, with number::displayPrecision significant digits
+// formatted by std::to_chars, which is much faster than the stream's own formatting and doesn't depend on its locale
+void writeNumber(std::ostream& stream, Number value);
+
+// stream where results and command outputs are written, std::cout unless redirected
+// redirections only apply to the current thread
+std::ostream& output();
+
+// stream where errors and warnings are written, std::cerr unless redirected
+std::ostream& errorOutput();
+
+// redirects output() while alive
+class OutputRedirection {
+public:
+	explicit OutputRedirection(std::ostream& stream);
+	~OutputRedirection();
+
+	OutputRedirection(const OutputRedirection&) = delete;
+	OutputRedirection& operator=(const OutputRedirection&) = delete;
+
+private:
+	std::ostream* previousStream{};
+};
+
+// redirects errorOutput() while alive
+class ErrorOutputRedirection {
+public:
+	explicit ErrorOutputRedirection(std::ostream& stream);
+	~ErrorOutputRedirection();
+
+	ErrorOutputRedirection(const ErrorOutputRedirection&) = delete;
+	ErrorOutputRedirection& operator=(const ErrorOutputRedirection&) = delete;
+
+private:
+	std::ostream* previousStream{};
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "PipelineStatistics.hpp"
+#include "EvaluationArena.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifndef CALCULATOR_NO_STATISTICS
+
+// counters of a thread, only written by it, but read by any thread when summed
+struct ThreadCounters {
+	struct Counters {
+		std::atomic<std::uint64_t> calls{};
+		std::atomic<std::uint64_t> nanoseconds{};
+		std::atomic<std::uint64_t> allocatedBytes{};
+	};
+
+	ThreadCounters();
+	~ThreadCounters();
+
+	std::array<Counters, nStages> stages{};
+	std::atomic<std::uint64_t> deduplicatedNodes{};
+};
+
+static std::mutex registryMutex{};
+static std::vector<ThreadCounters*> registeredCounters{};
+static std::array<StageStatistics, nStages> finishedThreadsStatistics{};
+static std::uint64_t finishedThreadsDeduplicatedNodes{};
+
+static thread_local ThreadCounters threadCounters{};
+
+ThreadCounters::ThreadCounters() {
+	const std::lock_guard lock{ registryMutex };
+	registeredCounters.push_back(this);
+}
+
+// the counters of a finishing thread are kept
+ThreadCounters::~ThreadCounters() {
+	const std::lock_guard lock{ registryMutex };
+	for (std::size_t i{}; i < nStages; i++) {
+		finishedThreadsStatistics[i].calls += stages[i].calls.load(std::memory_order_relaxed);
+		finishedThreadsStatistics[i].nanoseconds += stages[i].nanoseconds.load(std::memory_order_relaxed);
+		finishedThreadsStatistics[i].allocatedBytes += stages[i].allocatedBytes.load(std::memory_order_relaxed);
+	}
+	finishedThreadsDeduplicatedNodes += deduplicatedNodes.load(std::memory_order_relaxed);
+	std::erase(registeredCounters, this);
+}
+
+// only the owning thread writes, so a load and a store are enough, and cheaper than an atomic increment
+static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+StageTimer::StageTimer(Stage stage) noexcept :
+	stage{ stage },
+	begin{ std::chrono::steady_clock::now() },
+	allocatedBytesBefore{ evaluationArena.allocatedBytes() }
+{
+}
+
+StageTimer::~StageTimer() {
+	const auto duration{ std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin) };
+	auto& counters{ threadCounters.stages[static_cast<std::size_t>(stage)] };
+	add(counters.calls, 1);
+	add(counters.nanoseconds, static_cast<std::uint64_t>(duration.count()));
+	add(counters.allocatedBytes, evaluationArena.allocatedBytes() - allocatedBytesBefore);
+}
+
+std::array<StageStatistics, nStages> pipelineStatistics() {
+	const std::lock_guard lock{ registryMutex };
+	auto statistics{ finishedThreadsStatistics };
+	for (const auto counters : registeredCounters) {
+		for (std::size_t i{}; i < nStages; i++) {
+			statistics[i].calls += counters->stages[i].calls.load(std::memory_order_relaxed);
+			statistics[i].nanoseconds += counters->stages[i].nanoseconds.load(std::memory_order_relaxed);
+			statistics[i].allocatedBytes += counters->stages[i].allocatedBytes.load(std::memory_order_relaxed);
+		}
+	}
+	return statistics;
+}
+
+void countDeduplicatedNodes(std::uint64_t count) noexcept {
+	add(threadCounters.deduplicatedNodes, count);
+}
+
+std::uint64_t deduplicatedNodes() {
+	const std::lock_guard lock{ registryMutex };
+	auto count{ finishedThreadsDeduplicatedNodes };
+	for (const auto counters : registeredCounters) {
+		count += counters->deduplicatedNodes.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+// assumes no other thread is running a stage
+void resetPipelineStatistics() {
+	const std::lock_guard lock{ registryMutex };
+	finishedThreadsStatistics = {};
+	finishedThreadsDeduplicatedNodes = 0;
+	for (const auto counters : registeredCounters) {
+		for (auto& stageCounters : counters->stages) {
+			stageCounters.calls.store(0, std::memory_order_relaxed);
+			stageCounters.nanoseconds.store(0, std::memory_order_relaxed);
+			stageCounters.allocatedBytes.store(0, std::memory_order_relaxed);
+		}
+		counters->deduplicatedNodes.store(0, std::memory_order_relaxed);
+	}
+}
+
+#else
+
+std::array<StageStatistics, nStages> pipelineStatistics() {
+	return {};
+}
+
+void countDeduplicatedNodes([[maybe_unused]] std::uint64_t count) noexcept {}
+
+std::uint64_t deduplicatedNodes() {
+	return 0;
+}
+
+void resetPipelineStatistics() {}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+// per-stage counters of the evaluation pipeline, kept by each thread and summed on demand
+// compiling with CALCULATOR_NO_STATISTICS defined removes them, StageTimer then does nothing
+enum class Stage {
+	SyntaxChecking,
+	RemoveSpaces,
+	AddImplicitMultiplyOperators,
+	SimplifyOperators,
+	Tokenize,
+	Parse,
+	Optimize,
+	Evaluate,
+
+	Max
+};
+
+constexpr std::size_t nStages{ static_cast<std::size_t>(Stage::Max) };
+
+constexpr std::array<std::string_view, nStages> stageNames{
+	"syntax checking",
+	"removeSpaces",
+	"addImplicitMultiplyOperators",
+	"simplifyOperators",
+	"tokenize",
+	"parse",
+	"optimize",
+	"evaluate"
+};
+
+struct StageStatistics {
+	std::uint64_t calls{};
+	std::uint64_t nanoseconds{};
+	std::uint64_t allocatedBytes{}; // in evaluationArena
+};
+
+#ifdef CALCULATOR_NO_STATISTICS
+constexpr bool arePipelineStatisticsEnabled{ false };
+#else
+constexpr bool arePipelineStatisticsEnabled{ true };
+#endif
+
+// counts a call to a stage, its duration and what it allocated, from its construction to its destruction
+class StageTimer {
+public:
+#ifdef CALCULATOR_NO_STATISTICS
+	explicit StageTimer([[maybe_unused]] Stage stage) noexcept {}
+#else
+	explicit StageTimer(Stage stage) noexcept;
+	~StageTimer();
+
+private:
+	Stage stage{};
+	std::chrono::steady_clock::time_point begin{};
+	std::size_t allocatedBytesBefore{};
+#endif
+};
+
+// sums the counters of all the threads, including the finished ones
+std::array<StageStatistics, nStages> pipelineStatistics();
+
+// counts the nodes which optimize() shared rather than writing them again, as identical ones were already written
+void countDeduplicatedNodes(std::uint64_t count) noexcept;
+
+// sum of all the threads, as pipelineStatistics()
+std::uint64_t deduplicatedNodes();
+
+void resetPipelineStatistics();
\ No newline at end of file
@@ -1,29 +1,31 @@
-#pragma once
-#include <vector>
-#include <string>
-#include <optional>
-
-#include "CharacterType.hpp"
-
-std::vector<std::string> splitFormula(const std::string& formula);
-
-// simplifies '+' and '-', by removing useless ones or transforming for instance '+-' into only '-'
-std::string simplifyOperators(const std::string& formula);
-
-// assumes that parenthesises and angle brackets were checked previously
-// returns { A, B } -> the most nested area is formula[A to B - 1]
-std::pair<std::size_t, std::size_t> mostNestedDelimiterIndexes(const std::vector<std::string>& formula);
-
-std::size_t maxPriorityOperatorIndex(const std::vector<std::string>& formula);
-
-// adds '*' between delimiters -> e.g "8(2)" => "8*(2)"
-// assumes syntax was previsouly checked
-std::string addImplicitMultiplyOperators(const std::string& formula);
-
-std::string removeSpaces(const std::string& formula);
-
-// assumes syntax was checked previously
-std::string replaceVariables(const std::string& formula);
-
-// assumes syntax was checked previously
-std::optional<long double> result(const std::string& formula);
\ No newline at end of file
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory_resource>
+#include <optional>
+#include <span>
+
+#include "CharacterType.hpp"
+#include "Expression.hpp"
+
+// front-end stages write into a buffer given by the caller, which is cleared first, so that it can be reused
+
+// simplifies '+' and '-', by removing useless ones or transforming for instance '+-' into only '-'
+void simplifyOperators(std::string_view formula, std::pmr::string& simplifiedFormula);
+
+// adds '*' between delimiters -> e.g "8(2)" => "8*(2)"
+// assumes syntax was previsouly checked
+void addImplicitMultiplyOperators(std::string_view formula, std::pmr::string& newFormula);
+
+void removeSpaces(std::string_view formula, std::pmr::string& reducedFormula);
+
+// runs the whole front-end : implicit '*', '+' / '-' simplification, tokenization, parsing and optimization
+// parameters are the ones of the function whose body is formula, if any (see tokenize)
+// temporaries are allocated in evaluationArena
+// assumes syntax was checked previously and spaces were removed
+Expression compile(std::string_view formula, std::span<const std::string_view> parameters = {});
+
+// compiled expressions are cached, so the front-end only runs once per formula, and hot ones run as threaded code
+// temporaries are allocated in evaluationArena, which must be reset between inputs
+// assumes syntax was checked previously
+EvaluationResult result(std::string_view formula);
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "SaveFile.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+constexpr std::array<char, 8> snapshotMagic{ 'C', 'A', 'L', 'C', 'V', 'A', 'R', 'S' };
+constexpr std::uint32_t snapshotVersion{ 1 };
+
+struct SnapshotHeader {
+	std::array<char, 8> magic{};
+	std::uint32_t version{};
+	std::uint32_t valueSize{};	// sizeof(Number) of the build which wrote the file
+	std::uint64_t count{};		// number of variables
+	std::uint64_t namesSize{};	// size of the string table
+};
+
+// writes data into a temporary file which then replaces path, so that the previous file is never partially overwritten
+static bool replaceFile(const std::string& path, std::span<const std::span<const char>> data) {
+	const auto temporaryPath{ path + ".tmp" };
+	std::FILE* file{ std::fopen(temporaryPath.c_str(), "wb") };
+	if (file == nullptr) {
+		return false;
+	}
+
+	bool success{ true };
+	for (const auto part : data) {
+		success = success && std::fwrite(part.data(), 1, part.size(), file) == part.size();
+	}
+	success = std::fclose(file) == 0 && success;
+
+	std::error_code error{};
+	if (success) {
+		std::filesystem::rename(temporaryPath, path, error);
+	}
+	if (!success || error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+// bytes of the objects of data
+template<typename T>
+static std::span<const char> bytes(std::span<const T> data) {
+	return { reinterpret_cast<const char*>(data.data()), data.size_bytes() };
+}
+
+bool writeSnapshot(const std::string& path, std::span<const SavedVariable> variables) {
+	std::vector<Number> values(variables.size());
+	std::vector<std::uint64_t> nameOffsets(variables.size() + 1); // the name i is names[nameOffsets[i] to nameOffsets[i + 1] - 1]
+	std::string names{};
+
+	for (std::size_t i{}; i < variables.size(); i++) {
+		values[i] = variables[i].value;
+		names += variables[i].name;
+		nameOffsets[i + 1] = names.size();
+	}
+
+	const SnapshotHeader header{ snapshotMagic, snapshotVersion, sizeof(Number), variables.size(), names.size() };
+
+	const std::array<std::span<const char>, 4> data{
+		bytes(std::span{ &header, 1 }),
+		bytes(std::span<const Number>{ values }),
+		bytes(std::span<const std::uint64_t>{ nameOffsets }),
+		bytes(std::span<const char>{ names })
+	};
+	return replaceFile(path, data);
+}
+
+bool writeTextSave(const std::string& path, std::span<const SavedVariable> variables) {
+	std::string text{};
+	char value[number::maxCharsSize];
+
+	for (const auto& variable : variables) {
+		text += variable.name;
+		text += ' ';
+		text.append(value, number::toChars(value, value + sizeof(value), variable.value).ptr);
+		text += '\n';
+	}
+	return replaceFile(path, std::array{ std::span<const char>{ text } });
+}
+
+std::optional<std::string> existingSaveFile() {
+	for (const auto fileName : { snapshotFileName, textSaveFileName }) {
+		if (std::filesystem::exists(fileName)) {
+			return std::string{ fileName };
+		}
+	}
+	return std::nullopt;
+}
+
+static bool readSnapshot(std::string_view content, const std::function<void(std::string_view, Number)>& callback) {
+	SnapshotHeader header{};
+	if (content.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, content.data(), sizeof(header));
+	if (header.version != snapshotVersion || header.valueSize != sizeof(Number)) {
+		return false;
+	}
+
+	const auto valuesBegin{ sizeof(header) };
+	const auto nameOffsetsBegin{ valuesBegin + header.count * sizeof(Number) };
+	const auto namesBegin{ nameOffsetsBegin + (header.count + 1) * sizeof(std::uint64_t) };
+	if (header.count > content.size() / sizeof(Number) || namesBegin > content.size() || header.namesSize != content.size() - namesBegin) {
+		return false;
+	}
+
+	// the mapping is page-aligned, but values are copied anyway in case the platform has stricter alignment requirements
+	const auto names{ content.substr(namesBegin) };
+	std::uint64_t nameBegin{};
+	std::memcpy(&nameBegin, content.data() + nameOffsetsBegin, sizeof(nameBegin));
+
+	for (std::size_t i{}; i < header.count; i++) {
+		Number value{};
+		std::uint64_t nameEnd{};
+		std::memcpy(&value, content.data() + valuesBegin + i * sizeof(Number), sizeof(value));
+		std::memcpy(&nameEnd, content.data() + nameOffsetsBegin + (i + 1) * sizeof(std::uint64_t), sizeof(nameEnd));
+		if (nameEnd < nameBegin || nameEnd > names.size()) {
+			return false;
+		}
+
+		callback(names.substr(nameBegin, nameEnd - nameBegin), value);
+		nameBegin = nameEnd;
+	}
+	return true;
+}
+
+// removes the spaces at the beginning of text, then the characters up to the next space, which are returned
+static std::string_view nextWord(std::string_view& text) {
+	constexpr std::string_view spaces{ " \t\n\v\f\r" };
+	const auto wordBegin{ std::min(text.find_first_not_of(spaces), text.size()) };
+	const auto wordEnd{ std::min(text.find_first_of(spaces, wordBegin), text.size()) };
+	const auto word{ text.substr(wordBegin, wordEnd - wordBegin) };
+	text.remove_prefix(wordEnd);
+	return word;
+}
+
+static bool readTextSave(std::string_view content, const std::function<void(std::string_view, Number)>& callback) {
+	for (auto name{ nextWord(content) }; !name.empty(); name = nextWord(content)) {
+		const auto valueText{ nextWord(content) };
+		Number value{};
+		const auto [end, error] { number::fromChars(valueText.data(), valueText.data() + valueText.size(), value) };
+		if (error != std::errc{} || end != valueText.data() + valueText.size()) {
+			return false;
+		}
+		callback(name, value);
+	}
+	return true;
+}
+
+bool readSaveFile(const std::string& path, const std::function<void(std::string_view name, Number value)>& callback) {
+	const MappedFile file{ path };
+	if (!file.isOpen()) {
+		return false;
+	}
+	if (file.content().starts_with(std::string_view{ snapshotMagic.data(), snapshotMagic.size() })) {
+		return readSnapshot(file.content(), callback);
+	}
+	return readTextSave(file.content(), callback);
+}
\ No newline at end of file
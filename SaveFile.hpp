@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "Number.hpp"
+
+constexpr std::string_view snapshotFileName{ "vars.bin" };
+constexpr std::string_view textSaveFileName{ "vars.txt" };
+
+struct SavedVariable {
+	std::string_view name{};
+	Number value{};
+};
+
+// binary save file : a header, the packed values, the offsets of the names in the string table, then the string table
+// it uses the byte order and the 'Number' representation of the machine which wrote it
+// written into a temporary file which then replaces the previous one, so that a save is never partially overwritten
+bool writeSnapshot(const std::string& path, std::span<const SavedVariable> variables);
+
+// text save file, one "<name> <value>" line per variable
+// values are written with the fewest digits which read back exactly the same value, so they aren't rounded
+// written into a temporary file which then replaces the previous one as well
+bool writeTextSave(const std::string& path, std::span<const SavedVariable> variables);
+
+// 'vars.bin' if it exists, otherwise 'vars.txt' if it exists
+std::optional<std::string> existingSaveFile();
+
+// calls callback for each variable of a binary or text save file, in the order of the file
+// binary files are mapped in memory, returns false if the file can't be read or is corrupted
+bool readSaveFile(const std::string& path, const std::function<void(std::string_view name, Number value)>& callback);
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "Server.hpp"
+#include <iostream>
+
+#ifdef __linux__
+#include "Commands.hpp"
+#include "ErrorsLogging.hpp"
+#include "Input.hpp"
+#include "Output.hpp"
+#include "Workspace.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// a connection whose pending line grows beyond this is closed, so that a client can't make the server's memory grow without bound
+constexpr std::size_t maxRequestSize{ 1 << 20 };
+
+constexpr std::size_t readSize{ 64 * 1024 };
+constexpr int maxEvents{ 64 };
+
+// closes a file descriptor when destroyed
+class FileDescriptor {
+public:
+	explicit FileDescriptor(int fileDescriptor) noexcept :
+		fileDescriptor{ fileDescriptor }
+	{
+	}
+
+	~FileDescriptor() {
+		if (fileDescriptor != -1) {
+			close(fileDescriptor);
+		}
+	}
+
+	FileDescriptor(const FileDescriptor&) = delete;
+	FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+	int get() const noexcept {
+		return fileDescriptor;
+	}
+
+private:
+	int fileDescriptor{ -1 };
+};
+
+struct Connection {
+	explicit Connection(int fileDescriptor) noexcept :
+		socket{ fileDescriptor }
+	{
+	}
+
+	FileDescriptor socket;
+	Workspace workspace{};
+	std::string received{}; // not processed yet, starts with the next request, whose line may be incomplete
+	std::string responses{}; // not sent yet, from 'sent'
+	std::size_t sent{};
+	std::size_t requests{}; // number of the current request, for the diagnostics
+	std::uint32_t events{ EPOLLIN }; // the ones the connection is registered for
+	bool closing{}; // the client sent 'quit' or closed its side, the connection is closed once its responses are sent
+};
+
+// where the requests write, cleared before each request
+struct RequestOutputs {
+	StringWriter results{};
+	StringWriter errors{};
+	std::ostream resultsStream{ &results };
+	std::ostream errorsStream{ &errors };
+};
+
+static void logSystemError(std::string_view action) {
+	std::cerr << "Unexpected error while trying to " << action << " : " << std::strerror(errno) << " !" << std::endl;
+}
+
+// appends each line of text to responses, preceded by prefix
+static void appendLines(std::string& responses, char prefix, std::string_view text) {
+	while (!text.empty()) {
+		const auto lineEnd{ text.find('\n') };
+		const auto line{ text.substr(0, lineEnd) };
+		responses += prefix;
+		responses += line;
+		responses += '\n';
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+	}
+}
+
+// why a command can't be run by a connection, as it would modify the state shared with the other connections rather than
+// its own workspace, std::nullopt if it can : displaying the cache, the nesting limit or the statistics is allowed
+static std::optional<std::string_view> rejectionReason(std::string_view request) {
+	CommandArgs args{};
+	if (!parseCommand(request, args)) {
+		return std::nullopt;
+	}
+
+	if (args[0] == "journal") { // the journal saves the variables of a single workspace, whereas each connection has its own
+		return "The journal isn't available in the server, as each connection has its own variables !";
+	}
+	if (args.size() > 1 && (args[0] == "cache" || args[0] == "nesting" || args[0] == "stats")) {
+		return "The cache capacity, the nesting limit and the statistics are shared by all the connections, so can't be modified in the server !";
+	}
+	return std::nullopt;
+}
+
+static void processRequest(Connection& connection, const std::string& request, RequestOutputs& outputs) {
+	outputs.results.clear();
+	outputs.errors.clear();
+	setDiagnosticsLine(++connection.requests);
+
+	if (request == "help") {
+		help(false); // the server's console can't be used to turn the pages
+	}
+	else if (const auto reason{ rejectionReason(request) }) {
+		logMessage(std::string{ reason.value() });
+	}
+	else {
+		processInput(request);
+	}
+
+	appendLines(connection.responses, '=', outputs.results.view());
+	appendLines(connection.responses, '!', outputs.errors.view());
+	connection.responses += '\n';
+}
+
+// processes the complete lines received, and also the last one if the client closed its side
+// returns false if the pending request is too long
+static bool processReceivedLines(Connection& connection, bool endOfStream, RequestOutputs& outputs) {
+	if (connection.closing) {
+		connection.received.clear(); // requests sent after 'quit' are ignored
+		return true;
+	}
+	std::string_view received{ connection.received };
+	if (received.empty()) {
+		return true;
+	}
+
+	const WorkspaceActivation activation{ connection.workspace };
+	thread_local std::string request{};
+
+	while (!received.empty() && !connection.closing) {
+		auto lineEnd{ received.find('\n') };
+		if (lineEnd == std::string_view::npos) {
+			if (!endOfStream) {
+				break;
+			}
+			lineEnd = received.size();
+		}
+
+		auto line{ received.substr(0, lineEnd) };
+		if (line.ends_with('\r')) {
+			line.remove_suffix(1);
+		}
+		received.remove_prefix(std::min(lineEnd + 1, received.size()));
+
+		if (line == "quit") {
+			connection.closing = true;
+			break;
+		}
+		request.assign(line);
+		processRequest(connection, request, outputs);
+	}
+
+	connection.received.erase(0, connection.received.size() - received.size());
+	return connection.received.size() <= maxRequestSize;
+}
+
+// returns false if the connection must be closed : it failed, or it was closing and everything is sent
+static bool sendResponses(Connection& connection) {
+	while (connection.sent < connection.responses.size()) {
+		const auto count{ send(connection.socket.get(), connection.responses.data() + connection.sent, connection.responses.size() - connection.sent, MSG_NOSIGNAL) };
+		if (count < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		connection.sent += static_cast<std::size_t>(count);
+	}
+
+	connection.responses.clear();
+	connection.sent = 0;
+	return !connection.closing;
+}
+
+// reads what the client sent, processes its requests and sends their responses
+// returns false if the connection must be closed
+static bool serve(Connection& connection, std::uint32_t events, RequestOutputs& outputs) {
+	if (events & EPOLLERR) {
+		return false;
+	}
+
+	if (events & (EPOLLIN | EPOLLHUP)) {
+		std::array<char, readSize> buffer{};
+		bool endOfStream{};
+
+		while (true) {
+			const auto count{ read(connection.socket.get(), buffer.data(), buffer.size()) };
+			if (count < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno != EAGAIN && errno != EWOULDBLOCK) {
+					return false;
+				}
+				break;
+			}
+			if (count == 0) {
+				endOfStream = true;
+				break;
+			}
+			connection.received.append(buffer.data(), static_cast<std::size_t>(count));
+		}
+
+		if (!processReceivedLines(connection, endOfStream, outputs)) {
+			return false;
+		}
+		connection.closing = connection.closing || endOfStream;
+	}
+
+	return sendResponses(connection);
+}
+
+// the connection isn't read while it has responses to send, so that a client which doesn't read them is slowed down
+static bool updateEvents(int epoll, Connection& connection) {
+	const std::uint32_t events{ connection.responses.empty() ? static_cast<std::uint32_t>(EPOLLIN) : static_cast<std::uint32_t>(EPOLLOUT) };
+	if (events == connection.events) {
+		return true;
+	}
+
+	epoll_event event{ .events = events, .data = { .fd = connection.socket.get() } };
+	connection.events = events;
+	return epoll_ctl(epoll, EPOLL_CTL_MOD, connection.socket.get(), &event) == 0;
+}
+
+static void acceptConnections(int epoll, int listeningSocket, std::unordered_map<int, Connection>& connections) {
+	while (true) {
+		const auto fileDescriptor{ accept4(listeningSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC) };
+		if (fileDescriptor < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED) {
+				logSystemError("accept a connection");
+			}
+			if (errno != EINTR && errno != ECONNABORTED) {
+				return;
+			}
+			continue;
+		}
+
+		const auto& connection{ connections.try_emplace(fileDescriptor, fileDescriptor).first->second };
+		epoll_event event{ .events = connection.events, .data = { .fd = fileDescriptor } };
+		if (epoll_ctl(epoll, EPOLL_CTL_ADD, fileDescriptor, &event) != 0) {
+			logSystemError("watch a connection");
+			connections.erase(fileDescriptor);
+		}
+	}
+}
+
+// a socket file left by a server which didn't stop properly is removed, but not the one of a running server
+static bool removeStaleSocket(const sockaddr_un& address) {
+	struct stat status{};
+	if (stat(address.sun_path, &status) != 0) {
+		return true;
+	}
+	if (!S_ISSOCK(status.st_mode)) {
+		std::cerr << "'" << address.sun_path << "' already exists and isn't a socket !" << std::endl;
+		return false;
+	}
+
+	const FileDescriptor probe{ socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) };
+	if (probe.get() != -1 && connect(probe.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+		std::cerr << "A server is already listening on '" << address.sun_path << "' !" << std::endl;
+		return false;
+	}
+	return unlink(address.sun_path) == 0;
+}
+
+int runServer(const std::string& socketPath) {
+	sockaddr_un address{ .sun_family = AF_UNIX, .sun_path = {} };
+	if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+		std::cerr << "Incorrect socket path : '" << socketPath << "', it must have between 1 and " << sizeof(address.sun_path) - 1 << " characters !" << std::endl;
+		return 1;
+	}
+	socketPath.copy(address.sun_path, socketPath.size());
+
+	// SIGINT and SIGTERM are received through a file descriptor, so that the event loop stops cleanly
+	sigset_t stopSignals{};
+	sigemptyset(&stopSignals);
+	sigaddset(&stopSignals, SIGINT);
+	sigaddset(&stopSignals, SIGTERM);
+	if (sigprocmask(SIG_BLOCK, &stopSignals, nullptr) != 0) {
+		logSystemError("block the stop signals");
+		return 1;
+	}
+	const FileDescriptor signals{ signalfd(-1, &stopSignals, SFD_NONBLOCK | SFD_CLOEXEC) };
+	const FileDescriptor listeningSocket{ socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0) };
+	const FileDescriptor epoll{ epoll_create1(EPOLL_CLOEXEC) };
+	if (signals.get() == -1 || listeningSocket.get() == -1 || epoll.get() == -1) {
+		logSystemError("create the server");
+		return 1;
+	}
+
+	if (!removeStaleSocket(address)) {
+		return 1;
+	}
+	if (bind(listeningSocket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listeningSocket.get(), SOMAXCONN) != 0) {
+		logSystemError("listen on '" + socketPath + "'");
+		return 1;
+	}
+
+	for (const auto fileDescriptor : { signals.get(), listeningSocket.get() }) {
+		epoll_event event{ .events = EPOLLIN, .data = { .fd = fileDescriptor } };
+		if (epoll_ctl(epoll.get(), EPOLL_CTL_ADD, fileDescriptor, &event) != 0) {
+			logSystemError("create the server");
+			unlink(address.sun_path);
+			return 1;
+		}
+	}
+
+	RequestOutputs outputs{};
+	const OutputRedirection outputRedirection{ outputs.resultsStream };
+	const ErrorOutputRedirection errorOutputRedirection{ outputs.errorsStream };
+
+	std::unordered_map<int, Connection> connections{};
+	std::array<epoll_event, maxEvents> events{};
+	for (bool running{ true }; running;) {
+		const auto eventCount{ epoll_wait(epoll.get(), events.data(), maxEvents, -1) };
+		if (eventCount < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			logSystemError("wait for the clients");
+			break;
+		}
+
+		for (const auto& event : std::span{ events.data(), static_cast<std::size_t>(eventCount) }) {
+			if (event.data.fd == signals.get()) {
+				running = false;
+			}
+			else if (event.data.fd == listeningSocket.get()) {
+				acceptConnections(epoll.get(), listeningSocket.get(), connections);
+			}
+			else if (const auto connection{ connections.find(event.data.fd) }; connection != connections.end()) {
+				if (!serve(connection->second, event.events, outputs) || !updateEvents(epoll.get(), connection->second)) {
+					connections.erase(connection); // also removes it from the epoll
+				}
+			}
+		}
+	}
+
+	unlink(address.sun_path);
+	return 0;
+}
+
+#else
+
+int runServer(const std::string&) {
+	std::cerr << "The server is only available on Linux !" << std::endl;
+	return 1;
+}
+
+#endif
\ No newline at end of file
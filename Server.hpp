@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+
+// serves the clients connected to a Unix domain socket created at socketPath, until SIGINT or SIGTERM
+// requests are lines, processed as if they were typed in the console, except 'quit' which closes the connection
+// the response to a request is made of the lines it writes, results prefixed by '=' and errors by '!', followed by an empty line
+// each connection has its own workspace (variables, bindings and compiled expressions), dropped when it closes
+// so 'journal' is rejected, it would mix the variables of all the connections into the same file, as are 'cache <capacity>',
+// 'nesting <limit>' and 'stats reset', which would change the settings and statistics of all the connections
+// 'save' and 'load' are allowed, but their files are in the server's working directory, shared by all the connections
+// connections are multiplexed by a single thread with epoll, so requests are processed one at a time, in their arrival order
+// only available on Linux, returns the exit code of the program
+int runServer(const std::string& socketPath);
\ No newline at end of file
@@ -1,77 +1,105 @@
-#include <iostream>
-#include <string_view>
-#include <array>
-#include <utility>
-
-#include "CharacterType.hpp"
-#include "SyntaxChecking.hpp"
-#include "ErrorsLogging.hpp"
-#include "Result.hpp"
-#include "Commands.hpp"
-
-#ifdef _WIN32
-#include <Windows.h>
-#include <locale>
-#endif
-
-int main(int argc, char* argv[]) {
-
-#ifdef _WIN32
-	// C locale to input accents
-	std::locale::global(std::locale(""));
-#endif
-
-	std::string input{};
-	std::size_t argvIndex{ 1 };
-
-	while (true) {
-		std::cout << "> ";
-
-		if (std::cmp_less(argvIndex, argc)) {
-			input = argv[argvIndex++];
-		}
-		else if (argc > 1 && std::cmp_equal(argvIndex, argc)) { // all parameters were computed
-			break;
-		}
-		else {
-			std::getline(std::cin, input);
-		}
-
-#ifdef _WIN32
-		// input is formatted as OEM (Microsoft's standard) and must be converted back to ASCII
-		OemToCharBuffA(input.c_str(), &input[0], static_cast<DWORD>(input.size()));
-#endif
-
-		if (input == "quit") {
-			break;
-		}
-		else if (input == "help") {
-			help();
-			continue;
-		}
-		else if (areAllCharactersSpaces(input)) { // all characters are spaces
-			std::cout << 0 << std::endl;
-			continue;
-		}
-		else if (isCommand(input)) {
-			const auto argumentErrors{ checkArguments(input) };
-			if (argumentErrors.has_value()) {
-				logError(argumentErrors.value().first, argumentErrors.value().second, input);
-			}
-			else {
-				executeCommand(input);
-			}
-		}
-		else if (isSyntaxCorrect(input)) {
-			const auto formulaResult{ result(input) };
-			if (formulaResult.has_value()) {
-				std::cout << formulaResult.value() << std::endl;
-			}
-		}
-		else {
-			checkSyntax(input);
-		}
-	}
-
-	return 0;
+#include <iostream>
+#include <string_view>
+#include <array>
+#include <utility>
+#include <charconv>
+
+#include "ErrorsLogging.hpp"
+#include "Input.hpp"
+#include "Journal.hpp"
+#include "Batch.hpp"
+#include "Server.hpp"
+#include "ThreadPool.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <locale>
+#endif
+
+int main(int argc, char* argv[]) {
+
+#ifdef _WIN32
+	// C locale to input accents
+	std::locale::global(std::locale(""));
+#endif
+
+	// '--diagnostics=<text|json>' may come first, it applies to all the modes
+	if (constexpr std::string_view diagnosticsOption{ "--diagnostics=" }; argc > 1 && std::string_view{ argv[1] }.starts_with(diagnosticsOption)) {
+		const auto format{ parseDiagnosticsFormat(std::string_view{ argv[1] }.substr(diagnosticsOption.size())) };
+		if (!format.has_value()) {
+			std::cerr << "Incorrect diagnostics format : " << argv[1] << ", expected --diagnostics=text or --diagnostics=json !" << std::endl;
+			return 1;
+		}
+		setDiagnosticsFormat(format.value());
+
+		// the remaining parameters are handled as if it weren't there
+		argv[1] = argv[0];
+		argv++;
+		argc--;
+	}
+
+	// '--batch <file> [--threads <N>]' processes each line of <file>, otherwise each parameter is processed as an input
+	if (argc > 1 && std::string_view{ argv[1] } == "--batch") {
+		std::size_t threadCount{ defaultThreadCount() };
+
+		if (argc == 5 && std::string_view{ argv[3] } == "--threads") {
+			const std::string_view threads{ argv[4] };
+			const auto [end, error] { std::from_chars(threads.data(), threads.data() + threads.size(), threadCount) };
+			if (error != std::errc{} || end != threads.data() + threads.size() || threadCount == 0) {
+				std::cerr << "Incorrect number of threads : " << threads << " !" << std::endl;
+				return 1;
+			}
+		}
+		else if (argc != 3) {
+			std::cerr << "Usage : " << argv[0] << " --batch <file> [--threads <N>]" << std::endl;
+			return 1;
+		}
+
+		return runBatch(argv[2], threadCount);
+	}
+
+	// '--serve <socket>' evaluates the requests of the clients connected to a Unix domain socket
+	if (argc > 1 && std::string_view{ argv[1] } == "--serve") {
+		if (argc != 3) {
+			std::cerr << "Usage : " << argv[0] << " --serve <socket>" << std::endl;
+			return 1;
+		}
+		return runServer(argv[2]);
+	}
+
+	// the journal of the previous session is resumed, so that its variables are restored as they were before it ended
+	if (hasJournal() && !journal.resume()) {
+		logMessage("Unexpected error while trying to resume the journal '" + std::string{ journalFileName } + "' !");
+	}
+
+	std::string input{};
+	std::size_t argvIndex{ 1 };
+	std::size_t inputCount{};
+
+	while (true) {
+		std::cout << "> ";
+
+		if (std::cmp_less(argvIndex, argc)) {
+			input = argv[argvIndex++];
+		}
+		else if (argc > 1 && std::cmp_equal(argvIndex, argc)) { // all parameters were computed
+			break;
+		}
+		else {
+			std::getline(std::cin, input);
+		}
+
+#ifdef _WIN32
+		// input is formatted as OEM (Microsoft's standard) and must be converted back to ASCII
+		OemToCharBuffA(input.c_str(), &input[0], static_cast<DWORD>(input.size()));
+#endif
+
+		if (input == "quit") {
+			break;
+		}
+		setDiagnosticsLine(++inputCount);
+		processInput(input);
+	}
+
+	return 0;
 }
\ No newline at end of file
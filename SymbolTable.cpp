@@ -0,0 +1,163 @@
+#include "SymbolTable.hpp"
+#include <algorithm>
+#include <functional>
+#include <numbers>
+
+SymbolTable variables{};
+
+SymbolTable::SymbolTable() :
+	nameOffsets{ 0 },
+	buckets(16, noSlot)
+{
+	reset();
+	clearModifications(); // a new table isn't a reset of the variables : only 'reset' removes the journaled ones
+}
+
+std::optional<SymbolTable::Slot> SymbolTable::find(std::string_view name) const noexcept {
+	const auto slot{ findSlot(name, std::hash<std::string_view>{}(name)) };
+	if (slot == noSlot || !defined[slot]) {
+		return std::nullopt;
+	}
+	return slot;
+}
+
+bool SymbolTable::contains(std::string_view name) const noexcept {
+	return find(name).has_value();
+}
+
+std::optional<SymbolTable::Slot> SymbolTable::findInterned(std::string_view name) const noexcept {
+	const auto slot{ findSlot(name, std::hash<std::string_view>{}(name)) };
+	if (slot == noSlot) {
+		return std::nullopt;
+	}
+	return slot;
+}
+
+SymbolTable::Slot SymbolTable::set(std::string_view name, const Value& value) {
+	const auto slot{ intern(name) };
+	set(slot, value);
+	return slot;
+}
+
+void SymbolTable::set(Slot slot, const Value& value) noexcept {
+	values[slot] = value;
+	defined[slot] = true;
+	markModified(slot);
+}
+
+void SymbolTable::erase(std::string_view name) noexcept {
+	const auto slot{ findSlot(name, std::hash<std::string_view>{}(name)) };
+	if (slot != noSlot) {
+		defined[slot] = false;
+		markModified(slot);
+	}
+}
+
+void SymbolTable::reset() {
+	std::fill(defined.begin(), defined.end(), false);
+	clearModifications();
+	isReset = true;
+	set("e", toValue(number::e));
+	set("pi", toValue(number::pi));
+}
+
+std::string_view SymbolTable::name(Slot slot) const noexcept {
+	return std::string_view{ names }.substr(nameOffsets[slot], nameOffsets[slot + 1] - nameOffsets[slot]);
+}
+
+bool SymbolTable::isDefined(Slot slot) const noexcept {
+	return defined[slot];
+}
+
+std::size_t SymbolTable::slotCount() const noexcept {
+	return values.size();
+}
+
+std::vector<SymbolTable::Slot> SymbolTable::sortedSlots() const {
+	std::vector<Slot> slots{};
+	for (Slot slot{}; slot < slotCount(); slot++) {
+		if (defined[slot]) {
+			slots.push_back(slot);
+		}
+	}
+	std::sort(slots.begin(), slots.end(), [this](Slot first, Slot second) { return name(first) < name(second); });
+	return slots;
+}
+
+bool SymbolTable::wasReset() const noexcept {
+	return isReset;
+}
+
+std::span<const SymbolTable::Slot> SymbolTable::modifiedSlots() const noexcept {
+	return modified;
+}
+
+void SymbolTable::clearModifications() noexcept {
+	for (const auto slot : modified) {
+		isModified[slot] = false;
+	}
+	modified.clear();
+	isReset = false;
+}
+
+void SymbolTable::markModified(Slot slot) noexcept {
+	if (!isModified[slot]) {
+		isModified[slot] = true;
+		modified.push_back(slot);
+	}
+}
+
+SymbolTable::Slot SymbolTable::findSlot(std::string_view name, std::size_t hash) const noexcept {
+	const auto mask{ buckets.size() - 1 };
+
+	// linear probing, there is always an empty bucket
+	for (auto bucket{ hash & mask }; buckets[bucket] != noSlot; bucket = (bucket + 1) & mask) {
+		const auto slot{ buckets[bucket] };
+		if (hashes[slot] == hash && this->name(slot) == name) {
+			return slot;
+		}
+	}
+	return noSlot;
+}
+
+SymbolTable::Slot SymbolTable::intern(std::string_view name) {
+	const auto hash{ std::hash<std::string_view>{}(name) };
+	if (const auto slot{ findSlot(name, hash) }; slot != noSlot) {
+		return slot;
+	}
+
+	const auto slot{ static_cast<Slot>(values.size()) };
+	values.push_back(integerValue(0));
+	defined.push_back(false);
+	isModified.push_back(false);
+	modified.reserve(values.capacity());
+	hashes.push_back(hash);
+	names += name;
+	nameOffsets.push_back(names.size());
+
+	if (2 * values.size() > buckets.size()) {
+		grow(); // also places the new slot
+	}
+	else {
+		const auto mask{ buckets.size() - 1 };
+		auto bucket{ hash & mask };
+		while (buckets[bucket] != noSlot) {
+			bucket = (bucket + 1) & mask;
+		}
+		buckets[bucket] = slot;
+	}
+	return slot;
+}
+
+void SymbolTable::grow() {
+	buckets.assign(2 * buckets.size(), noSlot);
+	const auto mask{ buckets.size() - 1 };
+
+	for (Slot slot{}; slot < slotCount(); slot++) {
+		auto bucket{ hashes[slot] & mask };
+		while (buckets[bucket] != noSlot) {
+			bucket = (bucket + 1) & mask;
+		}
+		buckets[bucket] = slot;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Value.hpp"
+
+// variables, whose names are interned once into dense slots : values are stored contiguously and accessed by slot,
+// names are looked up with an open-addressing hash table
+// a removed variable keeps its slot, so that compiled expressions referring to it are valid again once it is defined again
+class SymbolTable {
+public:
+	using Slot = std::uint32_t;
+
+	// defines the constants e and pi
+	SymbolTable();
+
+	// slot of a defined variable
+	std::optional<Slot> find(std::string_view name) const noexcept;
+
+	bool contains(std::string_view name) const noexcept;
+
+	// slot of a name interned by a variable, even removed since, std::nullopt if no variable ever had it
+	std::optional<Slot> findInterned(std::string_view name) const noexcept;
+
+	// creates or modifies a variable
+	Slot set(std::string_view name, const Value& value);
+
+	// modifies the value of an interned variable, which becomes defined
+	void set(Slot slot, const Value& value) noexcept;
+
+	void erase(std::string_view name) noexcept;
+
+	// removes all variables, except constants
+	void reset();
+
+	// assumes the slot is the one of a defined variable
+	Number value(Slot slot) const noexcept {
+		return toNumber(values[slot]);
+	}
+
+	// same as value(slot), but also tells whether it is an integer, which is computed once when the variable is set
+	const Value& exactValue(Slot slot) const noexcept {
+		return values[slot];
+	}
+
+	std::string_view name(Slot slot) const noexcept;
+
+	bool isDefined(Slot slot) const noexcept;
+
+	// true for e and pi, whose value never changes
+	static constexpr bool isConstant(Slot slot) noexcept {
+		return slot < constantsCount;
+	}
+
+	// number of slots, including the ones of removed variables
+	std::size_t slotCount() const noexcept;
+
+	// slots of the defined variables, sorted by name
+	std::vector<Slot> sortedSlots() const;
+
+	// changes since the last call to clearModifications(), so that they can be saved incrementally :
+	// whether reset() removed all variables, then the slots set or erased afterwards, each once, in the order of their first change
+	bool wasReset() const noexcept;
+	std::span<const Slot> modifiedSlots() const noexcept;
+	void clearModifications() noexcept;
+
+private:
+	static constexpr Slot noSlot{ std::numeric_limits<Slot>::max() };
+	static constexpr Slot constantsCount{ 2 }; // e and pi are interned first, by the constructor
+
+	// slot of an interned name, defined or not
+	Slot findSlot(std::string_view name, std::size_t hash) const noexcept;
+
+	Slot intern(std::string_view name);
+
+	// doubles the number of buckets and rehashes the names
+	void grow();
+
+	void markModified(Slot slot) noexcept;
+
+	std::vector<Value> values{};
+	std::vector<bool> defined{};
+	std::vector<std::size_t> hashes{};
+	std::string names{}; // all names one after the other
+	std::vector<std::size_t> nameOffsets{}; // the name of slot i is names[nameOffsets[i] to nameOffsets[i + 1] - 1]
+
+	std::vector<Slot> buckets{}; // their number is a power of 2, with at most half of them used
+
+	bool isReset{};
+	std::vector<Slot> modified{}; // its capacity is at least the number of slots, so that marking a slot never allocates
+	std::vector<bool> isModified{};
+};
+
+extern SymbolTable variables;
\ No newline at end of file
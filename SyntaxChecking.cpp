@@ -1,246 +1,274 @@
-#include <deque>
-#include <iostream>
-#include <functional>
-#include <array>
-
-#include "SyntaxChecking.hpp"
-#include "ErrorsLogging.hpp"
-#include "Commands.hpp"
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::multipleOperators(const std::string& formula) {
-	SyntaxErrorIndexes indexes{};
-
-	for (std::size_t i{}; i < formula.size() - 1; i++) {
-		if (isOperator(formula[i]) && isOperator(formula[i + 1]) && formula[i + 1] != '-' && formula[i + 1] != '+') { // 3+-2 <=> 3-2 ; 3--2 <=> 3+2
-			indexes.push_back(i);
-			indexes.push_back(i + 1);
-		}
-	}
-
-	if (indexes.empty()) {
-		return std::nullopt;
-	}
-	return indexes;
-}
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::multipleCommas(const std::string& formula) {
-	SyntaxErrorIndexes indexes{};
-
-	bool hasComma{};
-	std::size_t firstCommaPos{};
-	for (std::size_t i{}; const char c : formula) {
-		if (isOperator(c)) {
-			hasComma = false;
-		}
-		else if (c == '.') {
-			if (hasComma) {
-				indexes.push_back(firstCommaPos);
-				indexes.push_back(i);
-			}
-			hasComma = true;
-			firstCommaPos = i;
-		}
-		i++;
-	}
-	return std::nullopt;
-}
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::unmatchedDelimiters(const std::string& formula) {
-	std::deque<std::size_t> parenthesisesPos{};
-	std::deque<std::size_t> squareBracketsPos{};
-
-	// looking for unmatched parenthesis and/or angle brackets
-
-	for (std::size_t i{}; char c : formula) {
-		if (isDelimiter(c)) {
-			auto& posVector{ isParenthesis(c) ? parenthesisesPos : squareBracketsPos };
-			if (isOpeningDelimiter(c)) {
-				posVector.push_back(i);
-			}
-			else { // closing delimiter
-				if (posVector.size() == 0) {
-					return SyntaxErrorIndexes{ i };
-				}
-				else {
-					posVector.pop_back();
-				}
-			}
-		}
-		i++;
-	}
-
-	if (parenthesisesPos.empty() && squareBracketsPos.empty()) {
-		return std::nullopt;
-	}
-
-	// Showing where are the unmatched parenthesises / angle brackets
-
-	SyntaxErrorIndexes indexes{};
-
-	for (std::size_t i{}; i < formula.size(); i++) {
-		if (!parenthesisesPos.empty() && parenthesisesPos.front() == i) {
-			indexes.push_back(i);
-			parenthesisesPos.pop_front();
-		}
-		else if (!squareBracketsPos.empty() && squareBracketsPos.front() == i) {
-			indexes.push_back(i);
-			squareBracketsPos.pop_front();
-		}
-	}
-
-	return indexes;
-}
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::unrecognizedCharacters(const std::string& formula) {
-	SyntaxErrorIndexes unrecognizedCharacters{};
-
-	for (std::size_t i{}; i < formula.size(); i++) {
-
-		if (std::isalpha(formula[i]) || formula[i] == '_') {
-			const auto identifier{ longestSequenceOfAlphaCharacters(formula, i) };
-			if (variables.find(identifier) != variables.cend()) {
-				i += identifier.size() - 1;
-				continue;
-			}
-		}
-
-		else if (!isDigit(formula[i]) && !isDelimiter(formula[i]) && formula[i] != '.' && !isOperator(formula[i]) && !std::isspace(formula[i])) {
-			unrecognizedCharacters.push_back(i);
-		}
-	}
-	if (unrecognizedCharacters.empty()) {
-		return std::nullopt;
-	}
-	return unrecognizedCharacters;
-}
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::commasOutsideNumber(const std::string& formula) {
-	SyntaxErrorIndexes indexes{};
-
-	for (std::size_t i{}; char c : formula) {
-		if (c == '.') {
-
-			// no matters if a comma is at the end of the formula, "2." can be std::cin-ed and doesn't need a trailing zero
-			if (i == 0 || (!std::isdigit(formula[i - 1]) && formula[i - 1] != '.')) {
-				indexes.push_back(i);
-			}
-		}
-		i++;
-	}
-	if (indexes.empty()) {
-		return std::nullopt;
-	}
-	return indexes;
-}
-
-// assumes that parenthesis (matching + non-emptiness) and "two operators" were checked previously
-std::optional<syntax::SyntaxErrorIndexes> syntax::aloneOperators(const std::string& formula) {
-	SyntaxErrorIndexes indexes{};
-
-	if (isOperator(formula.front()) && formula.front() != '+' && formula.front() != '-') {
-		indexes.push_back(0);
-	}
-
-	if (formula.size() == 1) { // formula.front() == formula.back()
-		if (indexes.empty()) {
-			return std::nullopt;
-		}
-		return indexes;
-	}
-
-	// checks if there's an alone operator in parenthesises, e.g -> "(+)" ; "(8*)"
-	for (std::size_t i{ 1 }; i < formula.size() - 1; i++) {
-		if (isOperator(formula[i]) && (isOpeningDelimiter(formula[i - 1]) || isClosingDelimiter(formula[i + 1]))) {
-			indexes.push_back(i);
-		}
-	}
-
-	if (isOperator(formula.back())) {
-		indexes.push_back(formula.size() - 1);
-	}
-
-	if (indexes.empty()) {
-		return std::nullopt;
-	}
-	return indexes;
-}
-
-std::optional<syntax::SyntaxErrorIndexes> syntax::emptyDelimiters(const std::string& formula) {
-	SyntaxErrorIndexes indexes{};
-	
-	for (std::size_t i{}; i < formula.size() - 1; i++) {
-		if (formula[i] == '(' && formula[i + 1] == ')') {
-			indexes.push_back(i);
-			indexes.push_back(i + 1);
-		}
-		else if (formula[i] == '[' && formula[i + 1] == ']') {
-			indexes.push_back(i);
-			indexes.push_back(i + 1);
-		}
-	}
-
-	if (indexes.empty()) {
-		return std::nullopt;
-	}
-	return indexes;
-}
-
-std::optional<SyntaxErrorIndexes> syntax::unknownIdentifiers(const std::string& formula) {
-	SyntaxErrorIndexes errors{};
-
-	for (std::size_t i{}; i < formula.size(); i++) {
-
-		if (std::isalpha(formula[i]) || formula[i] == '_') {
-			const auto identifier{ longestSequenceOfAlphaCharacters(formula, i) }; // it is an existing variable because syntax was checked
-			if (variables.find(identifier) == variables.cend()) {
-				errors.push_back(i);
-			}
-			i += identifier.size() - 1;
-		}
-	}
-
-	if (errors.empty()) {
-		return std::nullopt;
-	}
-	return errors;
-}
-
-bool isSyntaxCorrect(const std::string& formula) {
-	if (formula.empty() || areAllCharactersSpaces(formula)) {
-		return true;
-	}
-
-	return
-		!syntax::unrecognizedCharacters(formula).has_value()	&&
-		!syntax::unknownIdentifiers(formula).has_value()		&&
-		!syntax::unmatchedDelimiters(formula).has_value()		&&
-		!syntax::multipleOperators(formula).has_value()			&&
-		!syntax::emptyDelimiters(formula).has_value()			&&
-		!syntax::aloneOperators(formula).has_value()			&&
-		!syntax::commasOutsideNumber(formula).has_value()		&&
-		!syntax::multipleCommas(formula).has_value();
-}
-
-void checkSyntax(const std::string& formula) {
-	using functionType = decltype(std::function(syntax::aloneOperators));
-
-	const std::array<functionType, nErrors> errors{
-		syntax::unrecognizedCharacters,
-		syntax::unknownIdentifiers,
-		syntax::unmatchedDelimiters,
-		syntax::multipleOperators,
-		syntax::emptyDelimiters,
-		syntax::aloneOperators,
-		syntax::commasOutsideNumber,
-		syntax::multipleCommas
-	};
-
-	for (std::size_t i{};  const auto & function : errors) {
-		const auto indexes{ function(formula) };
-		if (indexes.has_value()) {
-			logError(static_cast<Error>(i), indexes.value(), formula);
-			return;
-		}
-		i++;
-	}
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <cctype>
+#include <optional>
+#include <string_view>
+
+#include "SyntaxChecking.hpp"
+#include "Commands.hpp"
+#include "EvaluationArena.hpp"
+#include "FunctionTable.hpp"
+#include "SymbolTable.hpp"
+#include "PipelineStatistics.hpp"
+
+static std::atomic<std::size_t> maxDepth{ defaultMaxNestingDepth };
+
+void setMaxNestingDepth(std::size_t depth) noexcept {
+	maxDepth = depth;
+}
+
+std::size_t maxNestingDepth() noexcept {
+	return maxDepth;
+}
+
+// looking for unmatched parenthesis and/or angle brackets, only called if there are some
+static syntax::SyntaxErrorIndexes unmatchedOpeningDelimiters(std::string_view formula) {
+	std::deque<std::size_t> parenthesisesPos{};
+	std::deque<std::size_t> squareBracketsPos{};
+
+	for (std::size_t i{}; char c : formula) {
+		if (isDelimiter(c)) {
+			auto& posVector{ isParenthesis(c) ? parenthesisesPos : squareBracketsPos };
+			if (isOpeningDelimiter(c)) {
+				posVector.push_back(i);
+			}
+			else { // closing delimiter, always matched
+				posVector.pop_back();
+			}
+		}
+		i++;
+	}
+
+	// Showing where are the unmatched parenthesises / angle brackets
+
+	syntax::SyntaxErrorIndexes indexes{};
+
+	for (std::size_t i{}; i < formula.size(); i++) {
+		if (!parenthesisesPos.empty() && parenthesisesPos.front() == i) {
+			indexes.push_back(i);
+			parenthesisesPos.pop_front();
+		}
+		else if (!squareBracketsPos.empty() && squareBracketsPos.front() == i) {
+			indexes.push_back(i);
+			squareBracketsPos.pop_front();
+		}
+	}
+
+	return indexes;
+}
+
+// function call whose closing delimiter isn't reached yet
+struct OpenCall {
+	std::size_t nameIndex{};
+	std::size_t parametersCount{};
+	std::size_t depth{};			// of the delimiters around its arguments
+	std::size_t separators{};		// between its arguments, so far
+	bool isArgumentEmpty{ true };	// true until a character of its current argument is found
+};
+
+// index of the closest character before i which isn't a space, std::string_view::npos if there is none
+static std::size_t previousNonSpace(std::string_view formula, std::size_t i) noexcept {
+	while (i-- > 0) {
+		if (!std::isspace(formula[i])) {
+			return i;
+		}
+	}
+	return std::string_view::npos;
+}
+
+// index of the closest character after i which isn't a space, std::string_view::npos if there is none
+static std::size_t nextNonSpace(std::string_view formula, std::size_t i) noexcept {
+	while (++i < formula.size()) {
+		if (!std::isspace(formula[i])) {
+			return i;
+		}
+	}
+	return std::string_view::npos;
+}
+
+syntax::Diagnostics syntax::diagnose(std::string_view formula, std::span<const std::string_view> parameters) {
+	const StageTimer timer{ Stage::SyntaxChecking };
+	Diagnostics diagnostics{};
+	const auto errorIndexes = [&diagnostics](Error error) -> SyntaxErrorIndexes& {
+		return diagnostics[static_cast<std::size_t>(error)];
+	};
+
+	const auto isIdentifierCharacter = [](char c) {
+		return std::isalpha(c) || c == '_';
+	};
+
+	// delimiters are counted, their positions are only needed if some are unmatched
+	std::size_t openParenthesises{};
+	std::size_t openSquareBrackets{};
+	bool hasUnmatchedClosingDelimiter{};
+	const auto maxDepth{ maxNestingDepth() };
+
+	// calls are only tracked when there are some, innermost last
+	std::pmr::vector<OpenCall> openCalls{ evaluationArena.resource() };
+	std::optional<OpenCall> nextCall{}; // call whose opening delimiter comes next
+
+	for (std::size_t i{}; i < formula.size(); i++) {
+		const char c{ formula[i] };
+		const char next{ i + 1 < formula.size() ? formula[i + 1] : '\0' };
+		const bool endsArgument{ !openCalls.empty() && openCalls.back().depth == openParenthesises + openSquareBrackets && (isArgumentSeparator(c) || isClosingDelimiter(c)) };
+
+		if (!openCalls.empty() && !endsArgument && !std::isspace(c)) {
+			openCalls.back().isArgumentEmpty = false;
+		}
+
+		if (isIdentifierCharacter(c)) {
+			std::size_t identifierEnd{ i + 1 };
+			while (identifierEnd < formula.size() && isIdentifierCharacter(formula[identifierEnd])) {
+				identifierEnd++;
+			}
+
+			const auto identifier{ formula.substr(i, identifierEnd - i) };
+			if (std::find(parameters.begin(), parameters.end(), identifier) != parameters.end() || variables.contains(identifier)) {
+				// a known parameter or variable
+			}
+			else if (const auto function{ functions.find(identifier) }) {
+				// a function must be followed by its arguments, and can't be called once a variable used by its body is removed
+				const auto delimiter{ std::find_if_not(formula.cbegin() + static_cast<std::ptrdiff_t>(identifierEnd), formula.cend(), [](char character) { return std::isspace(character); }) };
+				if (delimiter == formula.cend() || !isOpeningDelimiter(*delimiter)) {
+					errorIndexes(Error::BadFunctionCall).push_back(i);
+				}
+				else if (!functions.isCallable(function.value())) {
+					errorIndexes(Error::UnknownIndentifier).push_back(i);
+				}
+				else {
+					nextCall = OpenCall{ .nameIndex = i, .parametersCount = functions.function(function.value()).parametersCount };
+				}
+			}
+			else {
+				errorIndexes(Error::UnknownIndentifier).push_back(i);
+			}
+			i = identifierEnd - 1;
+			continue;
+		}
+
+		if (!isDigit(c) && !isDelimiter(c) && c != '.' && !isOperator(c) && !isArgumentSeparator(c) && !std::isspace(c)) {
+			errorIndexes(Error::UnrecognizedCharacters).push_back(i);
+		}
+
+		// each argument of a call must be a formula, and calls must have as many arguments as their function has parameters
+		if (isArgumentSeparator(c)) {
+			if (!endsArgument || openCalls.back().isArgumentEmpty) {
+				errorIndexes(Error::BadFunctionCall).push_back(i);
+			}
+			if (endsArgument) {
+				openCalls.back().separators++;
+				openCalls.back().isArgumentEmpty = true;
+			}
+		}
+		else if (endsArgument && !hasUnmatchedClosingDelimiter) {
+			const auto call{ openCalls.back() };
+			openCalls.pop_back();
+			if (call.isArgumentEmpty) {
+				errorIndexes(Error::BadFunctionCall).push_back(i);
+			}
+			if (call.separators + 1 != call.parametersCount) {
+				errorIndexes(Error::BadFunctionCall).push_back(call.nameIndex);
+			}
+		}
+
+		// only the first unmatched closing delimiter is reported
+		if (isDelimiter(c) && !hasUnmatchedClosingDelimiter) {
+			auto& openDelimiters{ isParenthesis(c) ? openParenthesises : openSquareBrackets };
+			if (isOpeningDelimiter(c)) {
+				openDelimiters++;
+
+				// only the first delimiter beyond the limit is reported
+				if (openParenthesises + openSquareBrackets > maxDepth && errorIndexes(Error::NestingTooDeep).empty()) {
+					errorIndexes(Error::NestingTooDeep).push_back(i);
+				}
+
+				if (nextCall.has_value()) {
+					nextCall->depth = openParenthesises + openSquareBrackets;
+					openCalls.push_back(nextCall.value());
+					nextCall.reset();
+				}
+			}
+			else if (openDelimiters == 0) {
+				errorIndexes(Error::UnmatchedDelimiters).push_back(i);
+				hasUnmatchedClosingDelimiter = true;
+			}
+			else {
+				openDelimiters--;
+			}
+		}
+
+		// operators are checked against the characters around them which aren't spaces, as spaces are removed before parsing
+		// e.g -> "3 * * 2" has multiple operators, and "3 - " ends with an operator
+		const auto previous{ isOperator(c) ? previousNonSpace(formula, i) : std::string_view::npos };
+		const auto following{ isOperator(c) ? nextNonSpace(formula, i) : std::string_view::npos };
+
+		// 3+-2 <=> 3-2 ; 3--2 <=> 3+2
+		if (isOperator(c) && following != std::string_view::npos && isOperator(formula[following]) && formula[following] != '-' && formula[following] != '+') {
+			errorIndexes(Error::MultipleOperators).push_back(i);
+			errorIndexes(Error::MultipleOperators).push_back(following);
+		}
+
+		if ((c == '(' && next == ')') || (c == '[' && next == ']')) {
+			errorIndexes(Error::EmptyDelimiters).push_back(i);
+			errorIndexes(Error::EmptyDelimiters).push_back(i + 1);
+		}
+
+		if (isOperator(c)) {
+			// the formula may begin with '+' or '-' ; an operator can't follow an opening delimiter, precede a closing one or end the formula
+			// nor be next to an argument separator
+			const bool isAlone{
+				previous == std::string_view::npos ?
+				c != '+' && c != '-' :
+				following == std::string_view::npos || isOpeningDelimiter(formula[previous]) || isClosingDelimiter(formula[following]) ||
+				isArgumentSeparator(formula[previous]) || isArgumentSeparator(formula[following])
+			};
+			if (isAlone) {
+				errorIndexes(Error::AloneOperators).push_back(i);
+			}
+		}
+
+		// no matters if a comma is at the end of the formula, "2." can be std::cin-ed and doesn't need a trailing zero
+		if (c == '.' && (i == 0 || (!isDigit(formula[i - 1]) && formula[i - 1] != '.'))) {
+			errorIndexes(Error::CommasOutsideNumber).push_back(i);
+		}
+
+		// several commas in a number aren't reported : only the part before the second one is read, e.g -> "1.5.5" is read as 1.5
+	}
+
+	if (!hasUnmatchedClosingDelimiter && (openParenthesises > 0 || openSquareBrackets > 0)) {
+		errorIndexes(Error::UnmatchedDelimiters) = unmatchedOpeningDelimiters(formula);
+	}
+
+	// the name of a call with a wrong number of arguments is only reported at its closing delimiter, after its separators
+	std::sort(errorIndexes(Error::BadFunctionCall).begin(), errorIndexes(Error::BadFunctionCall).end());
+
+	return diagnostics;
+}
+
+bool isSyntaxCorrect(std::string_view formula, std::span<const std::string_view> parameters) {
+	if (formula.empty() || areAllCharactersSpaces(formula)) {
+		return true;
+	}
+
+	const auto diagnostics{ syntax::diagnose(formula, parameters) };
+	for (const auto& indexes : diagnostics) {
+		if (!indexes.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void checkSyntax(std::string_view formula, std::span<const std::string_view> parameters) {
+	const auto diagnostics{ syntax::diagnose(formula, parameters) };
+
+	// only the first error is logged
+	for (std::size_t i{}; const auto & indexes : diagnostics) {
+		if (!indexes.empty()) {
+			logError(static_cast<Error>(i), indexes, formula);
+			return;
+		}
+		i++;
+	}
 }
\ No newline at end of file
@@ -1,32 +1,35 @@
-#pragma once
-#include <string>
-#include <vector>
-#include <optional>
-#include <map>
-
-#include "CharacterType.hpp"
-
-namespace syntax {
-	using SyntaxErrorIndexes = std::vector<std::size_t>;
-
-	std::optional<SyntaxErrorIndexes> multipleOperators(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> multipleCommas(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> unmatchedDelimiters(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> unrecognizedCharacters(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> commasOutsideNumber(const std::string& formula);
-
-	// assumes that parenthesis (matching + non-emptiness) and "two operators" were checked previously
-	std::optional<SyntaxErrorIndexes> aloneOperators(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> emptyDelimiters(const std::string& formula);
-
-	std::optional<SyntaxErrorIndexes> unknownIdentifiers(const std::string& formula);
-}
-
-bool isSyntaxCorrect(const std::string& formula);
-
-void checkSyntax(const std::string& formula);
\ No newline at end of file
+#pragma once
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <array>
+
+#include "CharacterType.hpp"
+#include "ErrorsLogging.hpp"
+
+// syntax errors of a formula are the first values of Error, from Error::UnrecognizedCharacters to Error::MultipleCommas
+constexpr std::size_t nSyntaxErrors{ static_cast<std::size_t>(Error::MultipleCommas) + 1 };
+
+namespace syntax {
+	using SyntaxErrorIndexes = std::vector<std::size_t>;
+
+	// error indexes of each syntax error, the i-th element being the indexes of static_cast<Error>(i)
+	using Diagnostics = std::array<SyntaxErrorIndexes, nSyntaxErrors>;
+
+	// finds all syntax errors with a single pass over the formula, and only allocates if there are errors
+	// parameters are the ones of the function whose body is formula, if any : they are known identifiers, which hide variables
+	// assumes formula isn't empty
+	Diagnostics diagnose(std::string_view formula, std::span<const std::string_view> parameters = {});
+}
+
+// deepest nesting of parenthesises and square brackets accepted in a formula, deeper ones are rejected with Error::NestingTooDeep
+// formulas are parsed and evaluated without recursion, the limit only bounds their memory, which is linear in their depth
+// shared by all threads, as the cache capacity
+constexpr std::size_t defaultMaxNestingDepth{ 1'000'000 };
+void setMaxNestingDepth(std::size_t depth) noexcept;
+std::size_t maxNestingDepth() noexcept;
+
+bool isSyntaxCorrect(std::string_view formula, std::span<const std::string_view> parameters = {});
+
+void checkSyntax(std::string_view formula, std::span<const std::string_view> parameters = {});
\ No newline at end of file
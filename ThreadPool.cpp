@@ -0,0 +1,94 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threadCount) {
+	threadCount = std::max<std::size_t>(threadCount, 1);
+
+	for (std::size_t i{}; i < threadCount; i++) {
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+	for (std::size_t i{}; i < threadCount; i++) {
+		workers.emplace_back(&ThreadPool::work, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		const std::scoped_lock lock{ stateMutex };
+		stopping = true;
+	}
+	taskAvailable.notify_all();
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::submit(Task task) {
+	{
+		// only the submitting thread uses nextQueue
+		auto& queue{ *queues[nextQueue] };
+		nextQueue = (nextQueue + 1) % queues.size();
+
+		const std::scoped_lock lock{ queue.mutex };
+		queue.tasks.push_back(std::move(task));
+	}
+	{
+		const std::scoped_lock lock{ stateMutex };
+		pendingTasks++;
+	}
+	taskAvailable.notify_one();
+}
+
+std::size_t ThreadPool::size() const noexcept {
+	return workers.size();
+}
+
+void ThreadPool::work(std::size_t workerIndex) {
+	while (true) {
+		{
+			std::unique_lock lock{ stateMutex };
+			taskAvailable.wait(lock, [this] { return pendingTasks > 0 || stopping; });
+			if (pendingTasks == 0) { // stopping, and all tasks are done
+				return;
+			}
+			pendingTasks--;
+		}
+
+		// a task is reserved for this worker, but it may be in any queue
+		auto task{ takeTask(workerIndex) };
+		while (!task.has_value()) {
+			task = takeTask(workerIndex);
+		}
+		task.value()();
+	}
+}
+
+std::optional<ThreadPool::Task> ThreadPool::takeTask(std::size_t workerIndex) {
+	{
+		auto& ownQueue{ *queues[workerIndex] };
+		const std::scoped_lock lock{ ownQueue.mutex };
+		if (!ownQueue.tasks.empty()) {
+			auto task{ std::move(ownQueue.tasks.front()) };
+			ownQueue.tasks.pop_front();
+			return task;
+		}
+	}
+
+	for (std::size_t i{ 1 }; i < queues.size(); i++) {
+		auto& victimQueue{ *queues[(workerIndex + i) % queues.size()] };
+		const std::scoped_lock lock{ victimQueue.mutex };
+		if (!victimQueue.tasks.empty()) {
+			// the newest task, so that the owner keeps on processing its tasks in submission order
+			auto task{ std::move(victimQueue.tasks.back()) };
+			victimQueue.tasks.pop_back();
+			return task;
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::size_t defaultThreadCount() noexcept {
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
\ No newline at end of file
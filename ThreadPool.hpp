@@ -0,0 +1,52 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// each worker has its own queue of tasks, and steals tasks from the other queues when its own one is empty
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(std::size_t threadCount);
+
+	// waits for the remaining tasks to be done
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// tasks are spread over the workers' queues in a round-robin way
+	void submit(Task task);
+
+	std::size_t size() const noexcept;
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex{};
+		std::deque<Task> tasks{};
+	};
+
+	void work(std::size_t workerIndex);
+
+	// takes the oldest task of the worker's own queue, otherwise steals the newest task of another queue
+	std::optional<Task> takeTask(std::size_t workerIndex);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues{};
+	std::size_t nextQueue{};
+
+	std::mutex stateMutex{};
+	std::condition_variable taskAvailable{};
+	std::size_t pendingTasks{};
+	bool stopping{};
+
+	std::vector<std::thread> workers{};
+};
+
+// number of threads used when not specified, at least 1
+std::size_t defaultThreadCount() noexcept;
\ No newline at end of file
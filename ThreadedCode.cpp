@@ -0,0 +1,162 @@
+#include "ThreadedCode.hpp"
+#include "EvaluationArena.hpp"
+#include "PipelineStatistics.hpp"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+using OperandKind = ThreadedCode::OperandKind;
+using Operand = ThreadedCode::Operand;
+using Instruction = ThreadedCode::Instruction;
+using Handler = ThreadedCode::Handler;
+
+constexpr std::size_t nOperandKinds{ static_cast<std::size_t>(OperandKind::Max) };
+
+template<OperandKind kind>
+static const Value& load(const Operand& operand, const Value* results) noexcept {
+	if constexpr (kind == OperandKind::Number) {
+		return operand.number;
+	}
+	else if constexpr (kind == OperandKind::Variable) {
+		return variables.exactValue(static_cast<SymbolTable::Slot>(operand.index));
+	}
+	else {
+		return results[operand.index];
+	}
+}
+
+template<OperandKind kind>
+static std::optional<Error> loadHandler(const Instruction& instruction, const Value* results, Value& result) {
+	result = load<kind>(instruction.left, results);
+	return std::nullopt;
+}
+
+template<OperandKind kind>
+static std::optional<Error> negateHandler(const Instruction& instruction, const Value* results, Value& result) {
+	result = negate(load<kind>(instruction.left, results));
+	return std::nullopt;
+}
+
+template<Operator op, OperandKind leftKind, OperandKind rightKind>
+static std::optional<Error> operatorHandler(const Instruction& instruction, const Value* results, Value& result) {
+	const auto& leftValue{ load<leftKind>(instruction.left, results) };
+	const auto& rightValue{ load<rightKind>(instruction.right, results) };
+
+	if (leftValue.isInteger && rightValue.isInteger) {
+		if (const auto integer{ applyIntegerOperator(op, leftValue.integer, rightValue.integer) }) {
+			result.integer = integer.value(); // result.number is left as is, storing a Number is slower
+			result.isInteger = true;
+			return std::nullopt;
+		}
+	}
+
+	const auto left{ toNumber(leftValue) };
+	const auto right{ toNumber(rightValue) };
+	result.isInteger = false; // result.integer is left as is
+	if constexpr (op == Operator::Plus) {
+		result.number = left + right;
+	}
+	else if constexpr (op == Operator::Minus) {
+		result.number = left - right;
+	}
+	else if constexpr (op == Operator::Multiply) {
+		result.number = left * right;
+	}
+	else if constexpr (op == Operator::Power) {
+		result.number = number::pow(left, right);
+	}
+	else { // '/' and '%' may fail
+		const auto value{ applyOperator(op, left, right) };
+		if (const auto error{ std::get_if<Error>(&value) }) {
+			return *error;
+		}
+		result.number = std::get<Number>(value);
+	}
+	return std::nullopt;
+}
+
+// handlers[kind]
+template<std::size_t... kinds>
+static constexpr std::array<Handler, nOperandKinds> loadHandlers(std::index_sequence<kinds...>) {
+	return { loadHandler<static_cast<OperandKind>(kinds)>... };
+}
+
+template<std::size_t... kinds>
+static constexpr std::array<Handler, nOperandKinds> negateHandlers(std::index_sequence<kinds...>) {
+	return { negateHandler<static_cast<OperandKind>(kinds)>... };
+}
+
+// handlers[leftKind * nOperandKinds + rightKind]
+template<Operator op, std::size_t... kinds>
+static constexpr std::array<Handler, nOperandKinds * nOperandKinds> operatorHandlers(std::index_sequence<kinds...>) {
+	return { operatorHandler<op, static_cast<OperandKind>(kinds / nOperandKinds), static_cast<OperandKind>(kinds % nOperandKinds)>... };
+}
+
+static Handler operatorHandler(Operator op, OperandKind leftKind, OperandKind rightKind) {
+	constexpr auto kindPairs{ std::make_index_sequence<nOperandKinds * nOperandKinds>{} };
+	static constexpr std::array<std::array<Handler, nOperandKinds * nOperandKinds>, 6> handlers{
+		operatorHandlers<Operator::Modulo>(kindPairs),
+		operatorHandlers<Operator::Plus>(kindPairs),
+		operatorHandlers<Operator::Minus>(kindPairs),
+		operatorHandlers<Operator::Multiply>(kindPairs),
+		operatorHandlers<Operator::Divide>(kindPairs),
+		operatorHandlers<Operator::Power>(kindPairs)
+	}; // same order as the 'operators' string
+
+	return handlers[operatorPriority(op) - 1][static_cast<std::size_t>(leftKind) * nOperandKinds + static_cast<std::size_t>(rightKind)];
+}
+
+ThreadedCode::ThreadedCode(const Expression& expression) {
+	static constexpr auto loads{ loadHandlers(std::make_index_sequence<nOperandKinds>{}) };
+	static constexpr auto negates{ negateHandlers(std::make_index_sequence<nOperandKinds>{}) };
+
+	// numbers and variables become operands of the instructions using them, other nodes become instructions
+	std::pmr::vector<std::pair<OperandKind, Operand>> operands(expression.nodes.size(), evaluationArena.resource());
+
+	for (std::size_t i{}; const auto & node : expression.nodes) {
+		switch (node.type) {
+		case NodeType::Number:
+			operands[i] = { OperandKind::Number, { .number = node.number } };
+			break;
+
+		case NodeType::Variable:
+			operands[i] = { OperandKind::Variable, { .index = node.variable } };
+			break;
+
+		case NodeType::Negate: {
+			const auto& [kind, operand] { operands[node.left] };
+			instructions.push_back({ negates[static_cast<std::size_t>(kind)], operand });
+			operands[i] = { OperandKind::Result, { .index = instructions.size() - 1 } };
+			break;
+		}
+
+		case NodeType::Operation: {
+			const auto& [leftKind, left] { operands[node.left] };
+			const auto& [rightKind, right] { operands[node.right] };
+			instructions.push_back({ operatorHandler(node.op, leftKind, rightKind), left, right });
+			operands[i] = { OperandKind::Result, { .index = instructions.size() - 1 } };
+			break;
+		}
+		}
+		i++;
+	}
+
+	if (const auto& [kind, operand] { operands.back() }; kind != OperandKind::Result) { // the whole expression is a number or a variable
+		instructions.push_back({ loads[static_cast<std::size_t>(kind)], operand });
+	}
+}
+
+EvaluationResult ThreadedCode::run() const {
+	const StageTimer timer{ Stage::Evaluate };
+	// value-initialized, as for evaluate()
+	Value* const results{ std::pmr::polymorphic_allocator<Value>{ evaluationArena.resource() }.allocate(instructions.size()) };
+	std::memset(static_cast<void*>(results), 0, instructions.size() * sizeof(Value));
+
+	for (std::size_t i{}; i < instructions.size(); i++) {
+		if (const auto error{ instructions[i].handler(instructions[i], results, results[i]) }) {
+			return error.value();
+		}
+	}
+	return results[instructions.size() - 1];
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <optional>
+#include <vector>
+
+#include "Expression.hpp"
+
+// expression compiled into a flat sequence of handlers, one per operator, called one after the other
+// each handler is specialized for its operator and the kinds of its operands, so that loading a number or a variable
+// is fused into it and evaluating doesn't go through a switch per node
+class ThreadedCode {
+public:
+	// assumes expression isn't empty
+	explicit ThreadedCode(const Expression& expression);
+
+	// same result and errors as evaluate(expression)
+	// temporaries are allocated in evaluationArena
+	EvaluationResult run() const;
+
+	enum class OperandKind {
+		Result,		// computed by a previous instruction
+		Number,
+		Variable,
+
+		Max
+	};
+
+	struct Operand {
+		Value number{};			// only for OperandKind::Number
+		std::size_t index{};	// index of the instruction for OperandKind::Result, slot for OperandKind::Variable
+	};
+
+	struct Instruction;
+
+	// writes the result of an instruction, returns the error if it fails
+	using Handler = std::optional<Error> (*)(const Instruction& instruction, const Value* results, Value& result);
+
+	struct Instruction {
+		Handler handler{};
+		Operand left{};		// the only operand of unary handlers
+		Operand right{};
+	};
+
+private:
+	std::vector<Instruction> instructions{};
+};
\ No newline at end of file
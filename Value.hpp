@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "Number.hpp"
+
+// value of a literal or computed while evaluating : integers are kept exact on 64 bits, as long as the operations on them
+// don't overflow and have an integer result, otherwise values are Numbers
+struct Value {
+	Number number{};		// only if !isInteger
+	std::int64_t integer{};	// only if isInteger
+	bool isInteger{};
+};
+
+inline Value integerValue(std::int64_t integer) noexcept {
+	return { .integer = integer, .isInteger = true };
+}
+
+// an integer if number is an integer within the range of std::int64_t
+inline Value toValue(Number number) noexcept {
+	constexpr Number lowest{ -9223372036854775808.0 }; // -2^63, the range is [-2^63 ; 2^63[
+	if (number >= lowest && number < -lowest) {
+		const auto integer{ static_cast<std::int64_t>(number) };
+		if (static_cast<Number>(integer) == number) {
+			return integerValue(integer);
+		}
+	}
+	return { .number = number };
+}
+
+inline Number toNumber(const Value& value) noexcept {
+	return value.isInteger ? static_cast<Number>(value.integer) : value.number;
+}
+
+// only the active members are compared, an integer is never equal to a Number, even with the same value
+inline bool operator==(const Value& first, const Value& second) noexcept {
+	if (first.isInteger != second.isInteger) {
+		return false;
+	}
+	return first.isInteger ? first.integer == second.integer : first.number == second.number;
+}
+
+inline Value negate(const Value& value) noexcept {
+	if (value.isInteger && value.integer != std::numeric_limits<std::int64_t>::min()) {
+		return integerValue(-value.integer);
+	}
+	return { .number = -toNumber(value) };
+}
+
+// integer operations, std::nullopt if they overflow
+namespace integer {
+	inline std::optional<std::int64_t> add(std::int64_t left, std::int64_t right) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		std::int64_t result{};
+		return __builtin_add_overflow(left, right, &result) ? std::nullopt : std::optional{ result };
+#else
+		constexpr auto min{ std::numeric_limits<std::int64_t>::min() };
+		constexpr auto max{ std::numeric_limits<std::int64_t>::max() };
+		if ((right > 0 && left > max - right) || (right < 0 && left < min - right)) {
+			return std::nullopt;
+		}
+		return left + right;
+#endif
+	}
+
+	inline std::optional<std::int64_t> subtract(std::int64_t left, std::int64_t right) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		std::int64_t result{};
+		return __builtin_sub_overflow(left, right, &result) ? std::nullopt : std::optional{ result };
+#else
+		constexpr auto min{ std::numeric_limits<std::int64_t>::min() };
+		constexpr auto max{ std::numeric_limits<std::int64_t>::max() };
+		if ((right < 0 && left > max + right) || (right > 0 && left < min + right)) {
+			return std::nullopt;
+		}
+		return left - right;
+#endif
+	}
+
+	inline std::optional<std::int64_t> multiply(std::int64_t left, std::int64_t right) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		std::int64_t result{};
+		return __builtin_mul_overflow(left, right, &result) ? std::nullopt : std::optional{ result };
+#else
+		constexpr auto min{ std::numeric_limits<std::int64_t>::min() };
+		constexpr auto max{ std::numeric_limits<std::int64_t>::max() };
+		const bool overflows{ left > 0 ?
+			(right > 0 ? left > max / right : right < min / left) :
+			(right > 0 ? left < min / right : left != 0 && right < max / left)
+		};
+		if (overflows) {
+			return std::nullopt;
+		}
+		return left * right;
+#endif
+	}
+
+	// by squaring, in O(log(exponent)) multiplications
+	// std::nullopt too for a negative exponent, as the result isn't an integer, unless base is 1 or -1
+	inline std::optional<std::int64_t> power(std::int64_t base, std::int64_t exponent) noexcept {
+		if (exponent < 0) {
+			if (base == 1 || base == -1) {
+				return exponent % 2 == 0 ? 1 : base;
+			}
+			return std::nullopt;
+		}
+
+		std::int64_t result{ 1 };
+		while (true) {
+			if (exponent % 2 == 1) {
+				const auto product{ multiply(result, base) };
+				if (!product.has_value()) {
+					return std::nullopt;
+				}
+				result = product.value();
+			}
+			exponent /= 2;
+			if (exponent == 0) {
+				return result;
+			}
+
+			const auto square{ multiply(base, base) }; // if it overflows, so would the result, as there are remaining bits
+			if (!square.has_value()) {
+				return std::nullopt;
+			}
+			base = square.value();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "Workspace.hpp"
+#include <utility>
+
+// swapping only moves the buffers of the containers, whatever the number of variables
+static void swapWithGlobals(Workspace& workspace) noexcept {
+	std::swap(variables, workspace.variables);
+	std::swap(dependencyGraph, workspace.dependencyGraph);
+	std::swap(functions, workspace.functions);
+	expressionCache.swap(workspace.expressionCache);
+}
+
+WorkspaceActivation::WorkspaceActivation(Workspace& workspace) noexcept :
+	workspace{ workspace }
+{
+	swapWithGlobals(workspace);
+}
+
+WorkspaceActivation::~WorkspaceActivation() {
+	swapWithGlobals(workspace);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "DependencyGraph.hpp"
+#include "ExpressionCache.hpp"
+#include "FunctionTable.hpp"
+#include "SymbolTable.hpp"
+
+// variables of a client, with the bindings, the functions and the compiled expressions referring to their slots
+// a slot only means something in the symbol table which interned it, so the four are always switched together
+struct Workspace {
+	SymbolTable variables{};
+	DependencyGraph dependencyGraph{};
+	FunctionTable functions{};
+	ExpressionCache expressionCache{};
+};
+
+// makes processInput use workspace while alive, in the current thread
+// workspace is swapped with the global variables, dependency graph and functions, so workspaces must only be activated by one thread
+class WorkspaceActivation {
+public:
+	explicit WorkspaceActivation(Workspace& workspace) noexcept;
+	~WorkspaceActivation();
+
+	WorkspaceActivation(const WorkspaceActivation&) = delete;
+	WorkspaceActivation& operator=(const WorkspaceActivation&) = delete;
+
+private:
+	Workspace& workspace;
+};
\ No newline at end of file